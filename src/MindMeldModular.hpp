@@ -226,6 +226,7 @@ struct DispTwoColorItem : MenuItem {
 // poly stereo menu item
 struct PolyStereoItem : MenuItem {
 	int8_t *polyStereoSrc = nullptr;
+	bool allowPolyVoices = false;// when true, offer the per channel (voice) processing option, which is value 2
 
 	Menu *createChildMenu() override {
 		Menu *menu = new Menu;
@@ -237,6 +238,12 @@ struct PolyStereoItem : MenuItem {
 			[=]() {return *polyStereoSrc == 1;},
 			[=]() {*polyStereoSrc = 1;}
 		));
+		if (allowPolyVoices) {
+			menu->addChild(createCheckMenuItem("Process each channel (L/R pairs)", "",
+				[=]() {return *polyStereoSrc == 2;},
+				[=]() {*polyStereoSrc = 2;}
+			));
+		}
 		return menu;
 	}
 };
@@ -55,7 +55,8 @@ struct RouteMaster : Module {
 	PackedBytes4 miscSettings;
 	
 	// No need to save, with reset
-	SlewLimiterSingle gainSlewers[MAX_NUM];
+	TSlewLimiterSingle<simd::float_4> gainSlewers[2];// all MAX_NUM gains in 8 lanes (index with i >> 2 and i & 0x3)
+	bool gainsSettled;// when true, gainSlewers are all at their target (0 or 1), and a straight copy can be done
 	int updateControllerLabelsRequest;// 0 when nothing to do, 1 for read labels in widget
 	
 	// No need to save, no reset
@@ -119,9 +120,8 @@ struct RouteMaster : Module {
 			}
 		}
 		
-		for (int i = 0; i < MAX_NUM; i++) {
-			gainSlewers[i].setRiseFall(SLEW_RATE);
-		}
+		gainSlewers[0].setRiseFall(simd::float_4(SLEW_RATE));
+		gainSlewers[1].setRiseFall(simd::float_4(SLEW_RATE));
 	
 		onReset();
 	}
@@ -141,9 +141,9 @@ struct RouteMaster : Module {
 		resetNonJson();
 	}
 	void resetNonJson() {
-		for (int i = 0; i < MAX_NUM; i++) {
-			gainSlewers[i].reset();
-		}
+		gainSlewers[0].reset();
+		gainSlewers[1].reset();
+		gainsSettled = false;
 		updateControllerLabelsRequest = 1;
 	}
 
@@ -179,7 +179,7 @@ struct RouteMaster : Module {
 		// sel
 		json_t *selJ = json_object_get(rootJ, "sel");
 		if (selJ)
-			sel = json_integer_value(selJ);
+			sel = clamp((int)json_integer_value(selJ), 0, MAX_NUM - 1);// sel indexes the gains in process()
 
 		// name
 		json_t *nameJ = json_object_get(rootJ, "name");
@@ -216,14 +216,19 @@ struct RouteMaster : Module {
 			for (int i = 0; i < MAX_NUM; i++) {
 				if (selTriggers[i].process(params[SEL_PARAMS + i].getValue())) {
 					sel = i;
+					gainsSettled = false;
 				}
 			}		
 		}// userInputs refresh
 
 		
 		// gainSlewers
-		for (int i = 0; i < MAX_NUM; i++) {
-			gainSlewers[i].process(args.sampleTime, i == sel ? 1.0f : 0.0f);
+		if (!gainsSettled) {
+			simd::float_4 targets[2] = {simd::float_4(0.0f), simd::float_4(0.0f)};
+			targets[sel >> 2][sel & 0x3] = 1.0f;
+			gainSlewers[0].process(args.sampleTime, targets[0]);
+			gainSlewers[1].process(args.sampleTime, targets[1]);
+			gainsSettled = movemask(gainSlewers[0].out == targets[0]) == 0xF && movemask(gainSlewers[1].out == targets[1]) == 0xF;// movemask returns 0xF when 4 floats are equal
 		}
 		
 		
@@ -245,13 +250,26 @@ struct RouteMaster : Module {
 				}
 				if (outputs[OUT_OUTPUTS + w].getChannels() != maxInChans) {
 					outputs[OUT_OUTPUTS + w].setChannels(maxInChans);
-				}			
-				for (int c = 0; c < maxInChans; c++) {
-					float cmix = 0.0f;
-					for (int i = 0; i < INS; i++) {
-						cmix += inputs[IN_INPUTS + i + (INS * w)].getVoltage(c) * gainSlewers[i].out;
+				}
+				if (maxInChans <= 0) {
+					continue;
+				}
+				if (gainsSettled) {
+					// straight copy of the selected input, the other inputs have a gain of 0
+					int selChans = std::min(inputs[IN_INPUTS + sel + (INS * w)].getChannels(), maxInChans);
+					float* outVoltages = outputs[OUT_OUTPUTS + w].getVoltages();
+					memcpy(outVoltages, inputs[IN_INPUTS + sel + (INS * w)].getVoltages(), selChans * sizeof(float));
+					memset(&outVoltages[selChans], 0, (maxInChans - selChans) * sizeof(float));
+				}
+				else {
+					// crossfading, 4 channels at a time (unused channels of a port are always 0V)
+					for (int c = 0; c < maxInChans; c += 4) {
+						simd::float_4 cmix = 0.0f;
+						for (int i = 0; i < INS; i++) {
+							cmix += inputs[IN_INPUTS + i + (INS * w)].getVoltageSimd<simd::float_4>(c) * gainSlewers[i >> 2].out[i & 0x3];
+						}
+						outputs[OUT_OUTPUTS + w].setVoltageSimd(cmix, c);
 					}
-					outputs[OUT_OUTPUTS + w].setVoltage(cmix, c);
 				}
 			}
 		}
@@ -264,10 +282,28 @@ struct RouteMaster : Module {
 						outputs[OUT_OUTPUTS + o + (OUTS * w)].setChannels(numInChans);
 					}			
 				}
-				for (int o = 0; o < OUTS; o++) {
-					for (int c = 0; c < numInChans; c++) {
-						outputs[OUT_OUTPUTS + o + (OUTS * w)].setVoltage(
-							inputs[IN_INPUTS + w].getVoltage(c) * gainSlewers[o].out, c);
+				if (numInChans <= 0) {
+					continue;
+				}
+				if (gainsSettled) {
+					// straight copy to the selected output, and silence on the others
+					for (int o = 0; o < OUTS; o++) {
+						float* outVoltages = outputs[OUT_OUTPUTS + o + (OUTS * w)].getVoltages();
+						if (o == sel) {
+							memcpy(outVoltages, inputs[IN_INPUTS + w].getVoltages(), numInChans * sizeof(float));
+						}
+						else {
+							memset(outVoltages, 0, numInChans * sizeof(float));
+						}
+					}
+				}
+				else {
+					// crossfading, 4 channels at a time
+					for (int c = 0; c < numInChans; c += 4) {
+						simd::float_4 in = inputs[IN_INPUTS + w].getVoltageSimd<simd::float_4>(c);
+						for (int o = 0; o < OUTS; o++) {
+							outputs[OUT_OUTPUTS + o + (OUTS * w)].setVoltageSimd(in * gainSlewers[o >> 2].out[o & 0x3], c);
+						}
 					}
 				}
 			}
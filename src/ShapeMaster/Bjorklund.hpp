@@ -1,60 +1,132 @@
-// downloaded from https://gist.github.com/unohee/d4f32b3222b42de84a5f
-// modified by Marc Boulé 2021-02-14
-
-#include <cmath>
-#include <algorithm>
-#include <vector>
-
-
-class Bjorklund{   
-	int lengthOfSeq;
-	int pulseAmt;
-	std::vector<int>remainder;
-	std::vector<int>count;
-	std::vector<bool>sequence; //accessing sequence directly is discouraged. use LoadSequence()
-
-	public:
-
-	Bjorklund() {
-		lengthOfSeq = 0;
-		pulseAmt = 0;
-	};
-	
-	void init(int step, int pulse);
-	
-	void print();
-	
-	int getSequence(int index) {
-		return sequence.at(index);
-	}
-	
-	int nextOne(int onePos) {
-		// ignores current position (will start by incrementing)
-		// will automatically wrap around end point
-		do {
-			onePos++;
-			onePos %= size();
-		} while (getSequence(onePos) == 0);
-		return onePos;
-	}
-	
-	int randomOne() {
-		// find a random "1"
-		int onePos = std::rand() % size();
-		return nextOne(onePos);
-	}
-	
-	void randomRotate() {
-		// random rotate such that a "1" is in index 0
-		std::rotate(sequence.begin(), sequence.begin() + randomOne(), sequence.end());
-	}
-	
-	int size() {
-		return (int)sequence.size();
-	}
-
-	private:
-
-	void iter();
-	void buildSeq(int slot);
-};
\ No newline at end of file
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include "rack.hpp"
+
+using namespace rack;
+
+
+// Euclidean rhythm of up to 128 steps for the grid randomization, as a bitmask (step i is bit i & 63 of bits[i >> 6])
+// The pulses are placed with the closed form of the maximally even rhythm, which is the same necklace as the one
+//   the Bjorklund algorithm builds (G. Toussaint, "The Euclidean Algorithm Generates Traditional Musical Rhythms"),
+//   so no recursion or allocation is needed, and rotations and searches are bit operations
+class Bjorklund {
+	static const int MAX_STEPS = 128;
+
+	uint64_t bits[2] = {};
+	int lengthOfSeq = 0;
+	int pulseAmt = 0;
+
+
+	static constexpr uint64_t patternWord(int step, int pulse, int word, int bit = 63) {
+		// bits 0 to bit of the given word of E(pulse, step), with a pulse on step 0
+		return bit < 0 ? 0 : (patternWord(step, pulse, word, bit - 1) |
+			((word * 64 + bit < step && ((word * 64 + bit) * pulse) % step < pulse) ? (1ULL << bit) : 0));
+	}
+
+	static uint64_t lowMask(int n) {
+		// n lowest bits set, n in [0, 64]
+		return n >= 64 ? ~0ULL : ((1ULL << n) - 1);
+	}
+
+	void shiftRight(uint64_t* dest, int r) const {
+		// r in [1, 127]
+		if (r >= 64) {
+			dest[0] = bits[1] >> (r - 64);
+			dest[1] = 0;
+		}
+		else {
+			dest[0] = (bits[0] >> r) | (bits[1] << (64 - r));
+			dest[1] = bits[1] >> r;
+		}
+	}
+
+	void shiftLeft(uint64_t* dest, int l) const {
+		// l in [1, 127]
+		if (l >= 64) {
+			dest[1] = bits[0] << (l - 64);
+			dest[0] = 0;
+		}
+		else {
+			dest[1] = (bits[1] << l) | (bits[0] >> (64 - l));
+			dest[0] = bits[0] << l;
+		}
+	}
+
+
+	public:
+
+	void init(int step, int pulse) {
+		// step in [1, 128], pulse in [1, step]
+		lengthOfSeq = clamp(step, 1, MAX_STEPS);
+		pulseAmt = clamp(pulse, 1, lengthOfSeq);
+		bits[0] = patternWord(lengthOfSeq, pulseAmt, 0);
+		bits[1] = patternWord(lengthOfSeq, pulseAmt, 1);
+	}
+
+	int getSequence(int index) {
+		return (int)((bits[index >> 6] >> (index & 63)) & 0x1);
+	}
+
+	int nextOne(int onePos) {
+		// ignores current position (will start by incrementing)
+		// will automatically wrap around end point
+		int start = onePos + 1;
+		if (start >= lengthOfSeq) {
+			start = 0;
+		}
+		int word = start >> 6;
+		uint64_t rest = bits[word] & ~lowMask(start & 63);
+		if (rest != 0) {
+			return word * 64 + __builtin_ctzll(rest);
+		}
+		if (word == 0 && bits[1] != 0) {
+			return 64 + __builtin_ctzll(bits[1]);
+		}
+		// wrap around, there is always a pulse on or before start
+		return bits[0] != 0 ? __builtin_ctzll(bits[0]) : 64 + __builtin_ctzll(bits[1]);
+	}
+
+	int randomOne() {
+		// position of a random "1"
+		int n = random::u32() % pulseAmt;
+		if (n >= __builtin_popcountll(bits[0])) {
+			n -= __builtin_popcountll(bits[0]);
+			uint64_t word = bits[1];
+			for (; n > 0; n--) {
+				word &= word - 1;// clear lowest pulse
+			}
+			return 64 + __builtin_ctzll(word);
+		}
+		uint64_t word = bits[0];
+		for (; n > 0; n--) {
+			word &= word - 1;
+		}
+		return __builtin_ctzll(word);
+	}
+
+	void randomRotate() {
+		// random rotate such that a "1" is in index 0
+		int r = randomOne();
+		if (r == 0) {
+			return;
+		}
+		uint64_t right[2];
+		uint64_t left[2];
+		shiftRight(right, r);
+		shiftLeft(left, lengthOfSeq - r);
+		bits[0] = (right[0] | left[0]) & lowMask(lengthOfSeq);
+		bits[1] = (right[1] | left[1]) & lowMask(lengthOfSeq - 64 < 0 ? 0 : lengthOfSeq - 64);
+	}
+
+	int size() {
+		return lengthOfSeq;
+	}
+};
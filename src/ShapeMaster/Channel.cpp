@@ -14,8 +14,6 @@
 void Channel::construct(int _chanNum, bool* _running, uint32_t* _sosEosEoc, ClockDetector* _clockDetector, Input* _inputs, Output* _outputs, Param* _params, std::vector<ParamQuantity*>* _paramQuantitiesSrc, PresetAndShapeManager* _presetAndShapeManager) {
 	chanNum = _chanNum;
 	running = _running;
-	hpFilter.setParameters(true, 0.1f);
-	lpFilter.setParameters(false, 0.4f);
 	if (_inputs) {
 		inInput = &_inputs[IN_INPUTS + chanNum];
 		scInput = &_inputs[SIDECHAIN_INPUT];
@@ -66,6 +64,7 @@ void Channel::onReset(bool withParams) {
 	nodeTrigDuration = DEFAULT_NODETRIG_DURATION;
 	gridX = 16;
 	rangeIndex = 0;
+	ctrlRateIndex = 0;
 	channelSettings.cc4[0] = 0x0;// local invert shadow
 	channelSettings.cc4[1] = chanNum;// channel color
 	channelSettings.cc4[2] = POLY_NONE;// poly sum mode (see util.hpp for enum)
@@ -79,9 +78,9 @@ void Channel::onReset(bool withParams) {
 	channelSettings3.cc4[2] = 0;// idem
 	channelSettings3.cc4[3] = 0;// idem
 	channelSettings4.cc4[0] = 0;// 0 =  normal, 1 = force 0V CV when not stepping
-	channelSettings4.cc4[1] = 0;// unused
-	channelSettings4.cc4[2] = 0;// unused
-	channelSettings4.cc4[3] = 0;// unused
+	channelSettings4.cc4[1] = 0;// sidechain detector: 0 = peak (default), 1 = RMS
+	channelSettings4.cc4[2] = 0;// sidechain RMS window index, see scRmsWindows
+	channelSettings4.cc4[3] = 0;// sidechain look-ahead index, see scLookAheadTimes (0 is off)
 	presetPath = "";
 	shapePath = "";
 	chanName = string::f("Channel %i", chanNum + 1);
@@ -96,14 +95,22 @@ void Channel::resetNonJson() {
 	sampleTime = 1.0 / (double)APP->engine->getSampleRate();
 	xover.reset();
 	// lastCrossoverParamWithCv; automatically set in setCrossoverCutoffFreq()
-	hpFilter.reset();
+	if (scEngine) {
+		scEngine->reset(chanNum);
+	}
 	setHPFCutoffSqFreq(hpfCutoffSqFreq);	
-	lpFilter.reset();
 	setLPFCutoffSqFreq(lpfCutoffSqFreq);
+	updateScDetector();
 	smoothFilter.reset();
 	setSmoothCutoffFreq();
 	// lastSmoothParam; automatically set in setSmoothCutoffFreq()
 	lastProcessXt = 0.0;
+	ctrlRateCounter = -1;
+	ctrlRateEval = false;
+	ctrlRateJump = false;
+	ctrlRateXt = 0.0;
+	ctrlRateCv = 0.0f;
+	ctrlRateStep = 0.0f;
 	// setSlewRate();
 	// lastSlewParamWithCv; automatically set in setSlewRate()
 	updateChannelActive();// channelActive
@@ -111,9 +118,8 @@ void Channel::resetNonJson() {
 	vcaPostSize = 0;
 	scSignal = 0.0f;
 	scEnvelope = 0.0f;
-	scEnvSlewer.reset();
 	setSensitivity(sensitivity);
-	// scEnvSlewer; automatically set in setSensitivity(), sensitivity must be valid
+	// scEngine's envelope rise and fall; automatically set in setSensitivity(), sensitivity must be valid
 	warpPhaseResponseAmountWithCv = simd::float_4(paWarp->getValue(), paPhase->getValue(), paResponse->getValue(), paAmount->getValue());
 	warpPhaseResponseAmountCvConnected = false;
 	xoverSlewWithCv = simd::float_4(paCrossover->getValue(), paHigh->getValue(), paLow->getValue(), paSlew->getValue());
@@ -122,7 +128,7 @@ void Channel::resetNonJson() {
 }
 
 
-json_t* Channel::dataToJsonChannel(bool withParams, bool withProUnsyncMatch, bool withFullSettings) {
+json_t* Channel::dataToJsonChannel(bool withParams, bool withProUnsyncMatch, bool withFullSettings, bool withBinShape) {
 	json_t* channelJ = json_object();
 	if (withParams) {
 		json_object_set_new(channelJ, "phase", json_real(paPhase->getValue()));
@@ -142,6 +148,7 @@ json_t* Channel::dataToJsonChannel(bool withParams, bool withProUnsyncMatch, boo
 	json_object_set_new(channelJ, "nodeTrigDuration", json_real(nodeTrigDuration));
 	json_object_set_new(channelJ, "gridX", json_integer(gridX));
 	json_object_set_new(channelJ, "rangeIndex", json_integer(rangeIndex));
+	json_object_set_new(channelJ, "ctrlRateIndex", json_integer(ctrlRateIndex));
 	json_object_set_new(channelJ, "channelSettings", json_integer(channelSettings.cc1));
 	json_object_set_new(channelJ, "channelSettings2", json_integer(channelSettings2.cc1));
 	json_object_set_new(channelJ, "channelSettings3", json_integer(channelSettings3.cc1));
@@ -153,7 +160,7 @@ json_t* Channel::dataToJsonChannel(bool withParams, bool withProUnsyncMatch, boo
 		json_object_set_new(channelJ, "chanName", json_string(chanName.c_str()));
 	}
 	randomSettings.dataToJson(channelJ);
-	json_object_set_new(channelJ, "shape", shape.dataToJsonShape());
+	json_object_set_new(channelJ, "shape", shape.dataToJsonShape(withBinShape));
 	playHead.dataToJsonPlayHead(channelJ, withParams, withProUnsyncMatch, withFullSettings);
 
 	return channelJ;
@@ -224,6 +231,10 @@ bool Channel::dataFromJsonChannel(json_t *channelJ, bool withParams, bool isDirt
 	json_t *rangeIndexJ = json_object_get(channelJ, "rangeIndex");
 	if (rangeIndexJ) rangeIndex = json_integer_value(rangeIndexJ);
 	
+	ctrlRateIndex = 0;// legacy (for presets that didn't have a control rate saved in them)
+	json_t *ctrlRateIndexJ = json_object_get(channelJ, "ctrlRateIndex");
+	if (ctrlRateIndexJ) ctrlRateIndex = clamp((int)json_integer_value(ctrlRateIndexJ), 0, NUM_CTRL_RATES - 1);
+	
 	json_t *channelSettingsJ = json_object_get(channelJ, "channelSettings");
 	if (channelSettingsJ) {
 		PackedBytes4 newSettings;
@@ -263,7 +274,15 @@ bool Channel::dataFromJsonChannel(json_t *channelJ, bool withParams, bool isDirt
 	}
 
 	json_t *channelSettings4J = json_object_get(channelJ, "channelSettings4");
-	if (channelSettings4J) channelSettings4.cc1 = json_integer_value(channelSettings4J);
+	if (channelSettings4J) {
+		PackedBytes4 newSettings4;
+		newSettings4.cc1 = json_integer_value(channelSettings4J);
+		// the sidechain bytes index arrays in the audio thread, so they are clamped in case the patch is corrupt
+		newSettings4.cc4[1] = clamp((int)newSettings4.cc4[1], 0, NUM_SC_DETECTORS - 1);
+		newSettings4.cc4[2] = clamp((int)newSettings4.cc4[2], 0, NUM_SC_RMS_WINDOWS - 1);
+		newSettings4.cc4[3] = clamp((int)newSettings4.cc4[3], 0, NUM_SC_LOOKAHEADS - 1);
+		channelSettings4.cc1 = newSettings4.cc1;
+	}
 
 	json_t *presetPathJ = json_object_get(channelJ, "presetPath");
 	if (presetPathJ) presetPath = json_string_value(presetPathJ);
@@ -288,6 +307,9 @@ bool Channel::dataFromJsonChannel(json_t *channelJ, bool withParams, bool isDirt
 	if (shapeJ) shape.dataFromJsonShape(shapeJ);
 	
 	bool unsupportedSync = playHead.dataFromJsonPlayHead(channelJ, withParams, isDirtyCacheLoad, withFullSettings);
+	if (getTrigMode() == TM_OSC && wavetable) {
+		wavetable->startRenderer();
+	}
 	
 	if (!isDirtyCacheLoad) {
 		resetNonJson();
@@ -298,7 +320,7 @@ bool Channel::dataFromJsonChannel(json_t *channelJ, bool withParams, bool isDirt
 
 
 std::string Channel::getLengthText(bool* inactive) {
-	*inactive = (playHead.getTrigMode() == TM_CV);
+	*inactive = (playHead.getTrigMode() == TM_CV || playHead.getTrigMode() == TM_OSC);
 	#ifdef SM_PRO
 	if (isSync()) {
 		int _lengthSyncIndex = playHead.getLengthSync(false);
@@ -366,38 +388,33 @@ std::string Channel::getLengthText(bool* inactive) {
 }
 
 
-bool Channel::isDirty(Channel* refChan) {
+uint64_t Channel::calcDirtyHash() {
+	// hash of everything that the preset dirty state compares, see calcDirtyHashShape() for shapes
 	bool inactive;// unused for dirty comparison
-	if (std::round(paPhase->getValue() * 3600.0f) != std::round(refChan->paPhase->getValue() * 3600.0f)) return true;// 1 decimal deg comp		
-	if (std::round(paResponse->getValue() * 1e3f) != std::round(refChan->paResponse->getValue() * 1e3f)) return true;// percent comparison
-	if (std::round(paWarp->getValue() * 1e3f) != std::round(refChan->paWarp->getValue() * 1e3f)) return true;// percent comparison
-	if (std::round(paAmount->getValue() * 1e3f) != std::round(refChan->paAmount->getValue() * 1e3f)) return true;// percent comparison
-	if (std::round(paSlew->getValue() * 1e3f) != std::round(refChan->paSlew->getValue() * 1e3f)) return true;// percent comparison
-	if (std::round(paSmooth->getValue() * 1e3f) != std::round(refChan->paSmooth->getValue() * 1e3f)) return true;// percent comparison
-	if (!(getCrossoverText(&inactive) == refChan->getCrossoverText(&inactive))) return true;// text comparison (easier)
-	if (std::round(paHigh->getValue() * 1e3f) != std::round(refChan->paHigh->getValue() * 1e3f)) return true;// percent comparison
-	if (std::round(paLow->getValue() * 1e3f) != std::round(refChan->paLow->getValue() * 1e3f)) return true;// percent comparison
-	if (!(getHPFCutoffFreqText() == refChan->getHPFCutoffFreqText())) return true;// text comparison (easier)
-	if (!(getLPFCutoffFreqText() == refChan->getLPFCutoffFreqText())) return true;// text comparison (easier)
-	if (!(getSensitivityText(getSensitivity()) == refChan->getSensitivityText(refChan->getSensitivity()))) return true;// text comparison (easier)
-	if (!(getGainAdjustDbText(getGainAdjustVcaDb()) == refChan->getGainAdjustDbText(refChan->getGainAdjustVcaDb()))) return true;// text comparison (easier)
-	if (!(getGainAdjustDbText(getGainAdjustScDb()) == refChan->getGainAdjustDbText(refChan->getGainAdjustScDb()))) return true;// text comparison (easier)
-	if (gridX != refChan->gridX) return true;// int comparison
-	if (rangeIndex != refChan->rangeIndex) return true;// int comparison
-	// if (chanSettings.cc1 != refChan->chanSettings.cc1) return true;// 4x int comparison, but excluded from dirty comparison
-	// if (chanSettings2.cc1 != refChan->chanSettings2.cc1) return true;// 4x int comparison, but excluded from dirty comparison
-	// if (chanSettings3.cc1 != refChan->chanSettings3.cc1) return true;// 4x int comparison, but excluded from dirty comparison
-	// if (chanSettings4.cc1 != refChan->chanSettings4.cc1) return true;// 4x int comparison, but excluded from dirty comparison
-	// if (!(presetPath == refChan->presetPath)) return true;// text comp, not relevant for dirty comparison
-	// if (!(shapePath == refChan->shapePath)) return true;// text comp, not relevant for dirty comparison
-	// if (!(chanName == refChan->chanName)) return true;// text comp, not relevant for dirty comparison
-	if (playHead.isDirty(&(refChan->playHead))) {
-		return true;
-	}
-	if (randomSettings.isDirty(&(refChan->randomSettings))) {
-		return true;
-	}
-	return isDirtyShape(refChan);
+	DirtyHash dh;
+	dh.addRounded(paPhase->getValue() * 3600.0f);// 1 decimal deg
+	dh.addRounded(paResponse->getValue() * 1e3f);// percent
+	dh.addRounded(paWarp->getValue() * 1e3f);// percent
+	dh.addRounded(paAmount->getValue() * 1e3f);// percent
+	dh.addRounded(paSlew->getValue() * 1e3f);// percent
+	dh.addRounded(paSmooth->getValue() * 1e3f);// percent
+	dh.add(getCrossoverText(&inactive));// text (easier)
+	dh.addRounded(paHigh->getValue() * 1e3f);// percent
+	dh.addRounded(paLow->getValue() * 1e3f);// percent
+	dh.add(getHPFCutoffFreqText());// text (easier)
+	dh.add(getLPFCutoffFreqText());// text (easier)
+	dh.add(getSensitivityText(getSensitivity()));// text (easier)
+	dh.add(getGainAdjustDbText(getGainAdjustVcaDb()));// text (easier)
+	dh.add(getGainAdjustDbText(getGainAdjustScDb()));// text (easier)
+	dh.add((int64_t)gridX);
+	dh.add((int64_t)rangeIndex);
+	dh.add((int64_t)ctrlRateIndex);
+	// channelSettings, channelSettings2, channelSettings3 and channelSettings4 are excluded from dirty comparison
+	// presetPath, shapePath and chanName are not relevant for dirty comparison
+	playHead.addToDirtyHash(&dh);
+	randomSettings.addToDirtyHash(&dh);
+	shape.addToDirtyHash(&dh);
+	return dh.hash;
 }
 
 
@@ -407,10 +424,14 @@ void Channel::processSlow(ChanCvs *chanCvs) {
 		// setSlewRate();
 	// }
 	playHead.processSlow(chanCvs);
+	if (wavetable) {
+		wavetable->setActive(getTrigMode() == TM_OSC);
+	}
 }
 
 
-void Channel::process(bool fsDiv8, ChanCvs *chanCvs) {
+bool Channel::processHead(bool fsDiv8, ChanCvs *chanCvs) {
+	// everything up to the play head, returns true when a shape eval is needed (see evalShapesForProcess())
 	updateChannelActive();
 	
 	if (fsDiv8) {// a form of slow, but not as slow as processSlow()
@@ -509,21 +530,227 @@ void Channel::process(bool fsDiv8, ChanCvs *chanCvs) {
 	}
 
 
-	// shape processing
-	if (channelActive) {				
-		// process playhead and get shape CV
-		double prelastProcessXt = lastProcessXt;
+	// process playhead
+	if (channelActive) {
+		prelastProcessXt = lastProcessXt;
 		lastProcessXt = playHead.process(chanCvs);
-		float shapeCv;// should not have range applied to it
+		if (isCvForcedTo0V() || getTrigMode() == TM_OSC) {
+			ctrlRateCounter = -1;// control rate output must restart with a jump
+			return false;
+		}
+		return ctrlRateIndex == 0 || processCtrlRateHead();
+	}
+	ctrlRateCounter = -1;
+	return false;
+}
+
+
+bool Channel::processCtrlRateHead() {
+	// returns true when the shape must be evaluated this sample, i.e. every ctrlRateDivs[ctrlRateIndex] samples,
+	//   and also right away when the play head jumps (restart, loop, retrigger, CV jump, etc.), as seen after warp and phase
+	//   such that jumps from their modulation (and the wrap of a phase offset) are caught too
+	double newCtrlRateXt = applyWarpAndPhaseForProcess(lastProcessXt);
+	ctrlRateJump = ctrlRateCounter < 0 || std::fabs(newCtrlRateXt - ctrlRateXt) > 0.01;
+	ctrlRateXt = newCtrlRateXt;
+	ctrlRateCounter--;
+	ctrlRateEval = ctrlRateCounter <= 0 || ctrlRateJump;
+	if (ctrlRateEval) {
+		ctrlRateCounter = ctrlRateDivs[ctrlRateIndex];
+	}
+	return ctrlRateEval;
+}
+
+
+float Channel::processCtrlRateTail(float shapeCv) {
+	// shapeCv is only valid when ctrlRateEval is true
+	// the output ramps from its current value to each new eval over one control period (so it's one period late),
+	//   except when the play head jumped, where it jumps with it such that discontinuities stay sample accurate
+	if (ctrlRateEval) {
+		if (ctrlRateJump) {
+			ctrlRateCv = shapeCv;
+			ctrlRateStep = 0.0f;
+			return ctrlRateCv;
+		}
+		ctrlRateStep = (shapeCv - ctrlRateCv) / (float)ctrlRateDivs[ctrlRateIndex];
+	}
+	else if (getNodeTriggers() != 0) {
+		// node triggers and shape tracker need the segment of every sample (and a pcDelta that is not from the last eval)
+		float t;
+		shape.prepareEvalForProcess(ctrlRateXt, &t);
+	}
+	ctrlRateCv += ctrlRateStep;
+	return ctrlRateCv;
+}
+
+
+void Channel::evalShapesForProcess(Channel* channels, const bool* needsEval, float* shapeCvs) {
+	// warp, phase, shape and response (and amount) of 8 channels, done 4 channels at a time
+	// shapeCvs[c] is only valid when needsEval[c] is true
+	static const ShapeSegment noEvalSeg = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, ShapeSegment::SEG_FLAT};
+	for (int g = 0; g < 8; g += 4) {
+		if (!(needsEval[g] || needsEval[g + 1] || needsEval[g + 2] || needsEval[g + 3])) {
+			continue;// all four at control rate and between evals, or inactive
+		}
+		simd::float_4 warp;
+		simd::float_4 phase;
+		simd::float_4 response;
+		simd::float_4 amount;
+		simd::float_4 center;
+		for (int i = 0; i < 4; i++) {
+			Channel* chan = &channels[g + i];
+			warp[i] = -chan->warpPhaseResponseAmountWithCv[0];
+			phase[i] = chan->warpPhaseResponseAmountWithCv[1];
+			response[i] = chan->warpPhaseResponseAmountWithCv[2];
+			amount[i] = chan->warpPhaseResponseAmountWithCv[3];
+			center[i] = chan->shape.getPointY(0);
+		}
+		
+		// warp (the curve factor is done in float, but the x values stay in double)
+		double xt[4];
+		simd::float_4 u;
+		for (int i = 0; i < 4; i++) {
+			xt[i] = std::fmin(channels[g + i].lastProcessXt, 1.0);
+			u[i] = (float)(warp[i] > 0.0f ? 1.0 - xt[i] : xt[i]);
+		}
+		simd::float_4 warpFactor = curveFactorSimd(u, warp);
+		for (int i = 0; i < 4; i++) {
+			if (warp[i] > 0.0f) {
+				xt[i] = 1.0 - (1.0 - xt[i]) * (double)warpFactor[i];
+			}
+			else {
+				xt[i] *= (double)warpFactor[i];
+			}
+			// phase
+			xt[i] += (double)phase[i];
+			if (xt[i] > 1.0) {
+				xt[i] -= std::floor(xt[i]);
+			}
+		}
+		
+		// shape
+		const ShapeSegment* segs[4];
+		simd::float_4 t;
+		for (int i = 0; i < 4; i++) {
+			if (needsEval[g + i]) {
+				segs[i] = channels[g + i].shape.prepareEvalForProcess(xt[i], &t[i]);
+			}
+			else {
+				segs[i] = &noEvalSeg;
+				t[i] = 0.0f;
+			}
+		}
+		simd::float_4 cvVal = ShapeSegment::evalSimd(segs, t);
+		
+		// response
+		cvVal = simd::fmin(cvVal, 1.0f);
+		simd::float_4 isMirror = response > 0.0f;
+		u = simd::ifelse(isMirror, 1.0f - cvVal, cvVal);
+		u *= curveFactorSimd(u, response);
+		cvVal = simd::ifelse(isMirror, 1.0f - u, u);
+		
+		// amount
+		cvVal = center + (cvVal - center) * amount;
+		
+		for (int i = 0; i < 4; i++) {
+			shapeCvs[g + i] = cvVal[i];
+		}
+	}
+}
+
+
+void Channel::processVcaIn() {
+	// VCA input and sidechain input, before the sidechain engine processes the sidechains of all channels
+	scEngineInput = false;
+	if (!channelActive || getNodeTriggers() != 0) {
+		lookAhead.stop();
+		return;
+	}
+	
+	// vcaPre and vcaPreSize, 4 channels at a time (so vcaPre can have garbage past vcaPreSize)
+	vcaPreSize = inInput->getChannels();
+	if (vcaPreSize > 0) {
+		int8_t polyMode = getPolyMode();
+		if (vcaPreSize <= polyModeChanOut[polyMode]) {
+			// nothing to sum
+			for (int c = 0; c < vcaPreSize; c += 4) {
+				(inInput->getVoltageSimd<simd::float_4>(c) * gainAdjustVca).store(&vcaPre[c]);
+			}
+		}
+		else {
+			// stereo sums the even and odd channels, mono sums them all; the lanes past the last channel are masked
+			simd::float_4 sum = 0.0f;
+			for (int c = 0; c < vcaPreSize; c += 4) {
+				simd::float_4 isLaneUsed = simd::float_4(0.0f, 1.0f, 2.0f, 3.0f) < (float)(vcaPreSize - c);
+				sum += simd::ifelse(isLaneUsed, inInput->getVoltageSimd<simd::float_4>(c), 0.0f);
+			}
+			if (polyMode == POLY_STEREO) {
+				vcaPre[0] = (sum[0] + sum[2]) * gainAdjustVca;
+				vcaPre[1] = (sum[1] + sum[3]) * gainAdjustVca;
+			}
+			else {
+				vcaPre[0] = (sum[0] + sum[1] + sum[2] + sum[3]) * gainAdjustVca;
+			}
+			vcaPreSize = polyModeChanOut[polyMode];
+		}
+	}
+	
+	// scSignal (unfiltered)
+	scSignal = 0.0f;
+	if (getTrigMode() == TM_SC) {
+		bool needsScProcessing = false;
+		if (isSidechainUseVca() && vcaPreSize > 0) {
+			scSignal = vcaPre[0];
+			for (int c = 1; c < vcaPreSize; c++) {
+				scSignal += vcaPre[c];
+			}
+			needsScProcessing = true;
+		}
+		else if (!isSidechainUseVca() && scInput->getChannels() > chanNum) {
+			scSignal = scInput->getVoltage(chanNum);
+			needsScProcessing = true;	
+		}
+		if (needsScProcessing && scEngine) {
+			scEngine->setInput(chanNum, scSignal * gainAdjustSc);
+			scEngineInput = true;
+		}
 		
+		// look-ahead (the sidechain above is not delayed)
+		if (getScLookAheadIndex() != 0 && vcaPreSize > 0) {
+			lookAhead.process(vcaPre, vcaPreSize, lookAhead.calcDelay(scLookAheadTimes[getScLookAheadIndex()], sampleTime));
+		}
+		else {
+			lookAhead.stop();
+		}
+	}
+	else {
+		lookAhead.stop();
+	}
+}
+
+
+void Channel::processTail(float shapeCv) {
+	// everything after the shape eval, shapeCv must come from evalShapesForProcess() (when it was needed)
+	if (channelActive) {				
 		// CV OUTPUT
 		// --------
-		if (isForced0VWhenStopped() && getTrigMode() != TM_CV && playHead.getState() == PlayHead::STOPPED) {
+		if (isCvForcedTo0V()) {
 			shapeCv = 0.0f;
 			cvOutput->setVoltage(0.0f);
 		}
+		else if (getTrigMode() == TM_OSC) {
+			// audio rate: no slew and smoothing, and no warp and response since they would alias
+			double oscPhase = applyPhase<double>(lastProcessXt);
+			if (!wavetable || !wavetable->process(oscPhase, playHead.getOscNormFreq(), &shapeCv)) {
+				shapeCv = shape.evalShapeForProcess(oscPhase);// until the first rendering is published
+			}
+			shapeCv = applyAmount(shapeCv);
+			cvOutput->setVoltage(applyRange(shapeCv));
+		}
 		else {
-			shapeCv = evalShapeForProcess(lastProcessXt);
+			if (ctrlRateIndex != 0) {
+				shapeCv = processCtrlRateTail(shapeCv);
+			}
+			shapeCv = applySlewAndSmooth(shapeCv);// should not have range applied to it
 			cvOutput->setVoltage(applyRange(shapeCv));
 		}
 		
@@ -547,7 +774,7 @@ void Channel::process(bool fsDiv8, ChanCvs *chanCvs) {
 			}
 			else {
 				// node triggers
-				int pcDelta = shape.getPcDelta();
+				int pcDelta = getTrigMode() == TM_OSC ? 0 : shape.getPcDelta();// pc not updated in TM_OSC
 				if (pcDelta != 0) {
 					if (getTrigMode() == TM_CV) {
 						nodeTrigPulseGen.trigger(nodeTrigDuration);
@@ -570,48 +797,10 @@ void Channel::process(bool fsDiv8, ChanCvs *chanCvs) {
 			}
 		}
 		else {		
-			// vcaPre and vcaPreSize
-			vcaPreSize = inInput->getChannels();
-			if (vcaPreSize > 0) {
-				int vcaPreMax = std::min(vcaPreSize, polyModeChanOut[getPolyMode()]);
-				for (int c = 0; c < vcaPreSize; c++) {
-					if (c < vcaPreMax) {
-						vcaPre[c] = inInput->getVoltage(c) * gainAdjustVca;
-					}
-					else {
-						vcaPre[c % vcaPreMax] += inInput->getVoltage(c) * gainAdjustVca;
-					}
-				}
-				vcaPreSize = vcaPreMax;
-			}
-			
-			// scSignal
-			scSignal = 0.0f;
-			if (getTrigMode() == TM_SC) {
-				bool needsScProcessing = false;
-				if (isSidechainUseVca() && vcaPreSize > 0) {
-					scSignal = vcaPre[0];
-					for (int c = 1; c < vcaPreSize; c++) {
-						scSignal += vcaPre[c];
-					}
-					needsScProcessing = true;
-				}
-				else if (!isSidechainUseVca() && scInput->getChannels() > chanNum) {
-					scSignal = scInput->getVoltage(chanNum);
-					needsScProcessing = true;	
-				}
-				if (needsScProcessing) {
-					scSignal *= gainAdjustSc;
-					// HPF
-					if (isHpfCutoffActive()) {
-						scSignal = hpFilter.process(scSignal);
-					}
-					// LPF
-					if (isLpfCutoffActive()) {
-						scSignal = lpFilter.process(scSignal);
-					}
-					scEnvelope = scEnvSlewer.process(std::fabs(sampleTime), scSignal);
-				}
+			// vcaPre, vcaPreSize and scSignal were prepared in processVcaIn(), sidechain filters and envelope were done by the engine
+			if (scEngineInput) {
+				scSignal = scEngine->getSignal(chanNum);
+				scEnvelope = scEngine->getEnvelope(chanNum);
 			}
 			
 			
@@ -623,43 +812,31 @@ void Channel::process(bool fsDiv8, ChanCvs *chanCvs) {
 				if ((paCrossover->getValue() >= CROSSOVER_OFF) && vcaPreSize > 0) {
 					float gainLow = 1.0f + (shapeCv - 1.0f) * xoverSlewWithCv[2];//paLow->getValue();
 					float gainHigh = 1.0f + (shapeCv - 1.0f) * xoverSlewWithCv[1];//paHigh->getValue();
-					for (int c2 = 0; c2 < ((vcaPostSize + 1) >> 1); c2++) {
-						int iL = c2 << 1;
-						int iR = iL + 1;
-						simd::float_4 lrRes = xover.process(vcaPre[iL], vcaPre[iR], c2);
-						// lrRes[0] = left low, left high, right low, lrRes[3] = right high
-						vcaPost[iL] = lrRes[0] * gainLow + lrRes[1] * gainHigh;
-						vcaPost[iR] = lrRes[2] * gainLow + lrRes[3] * gainHigh;
+					for (int c = vcaPreSize; c < ((vcaPostSize + 3) & ~0x3); c++) {
+						vcaPre[c] = 0.0f;// xover processes 4 channels at a time
 					}
+					xover.processMix(vcaPre, vcaPost, vcaPostSize, gainLow, gainHigh);
 				}
 				else {
-					for (int c = 0; c < vcaPostSize; c++) {
-						if (c < vcaPreSize) {
-							vcaPost[c] = vcaPre[c] * shapeCv;
-						}
-						else {
-							vcaPost[c] = 0.0f;
-						}
+					// 4 channels at a time, the channels past vcaPreSize are 0V
+					for (int c = 0; c < vcaPostSize; c += 4) {
+						simd::float_4 isLaneUsed = simd::float_4(0.0f, 1.0f, 2.0f, 3.0f) < (float)(vcaPreSize - c);
+						simd::ifelse(isLaneUsed, simd::float_4::load(&vcaPre[c]) * shapeCv, 0.0f).store(&vcaPost[c]);
 					}
 				}		
 
-				// write VCA output, with possible audition crossfade
+				// write VCA output, with possible audition crossfade (4 channels at a time, the lanes past vcaPostSize are ignored by the cable)
 				if (playHead.getTrigMode() == TM_SC && playHead.getAudition() && playHead.getAuditionGain() != 0.0f) {
 					float auditionGain = playHead.getAuditionGain();
-					float crossfaded = vcaPost[0] * (1.0f - auditionGain) + scSignal * auditionGain;
-					outOutput->setVoltage(crossfaded, 0);
-					if (vcaPostSize > 1) {
-						crossfaded = vcaPost[1] * (1.0f - auditionGain) + scSignal * auditionGain;
-						outOutput->setVoltage(crossfaded, 1);
-					}
-					for (int c = 2; c < vcaPostSize; c++) {
-						crossfaded = vcaPost[c] * (1.0f - auditionGain) + 0.0f * auditionGain;
-						outOutput->setVoltage(crossfaded, c);
+					simd::float_4 scAudition = simd::float_4(scSignal, scSignal, 0.0f, 0.0f) * auditionGain;// sidechain is only auditioned on the first two channels
+					for (int c = 0; c < vcaPostSize; c += 4) {
+						outOutput->setVoltageSimd(simd::float_4::load(&vcaPost[c]) * (1.0f - auditionGain) + scAudition, c);
+						scAudition = 0.0f;
 					}
 				}
 				else {
-					for (int c = 0; c < vcaPostSize; c++) {
-						outOutput->setVoltage(vcaPost[c], c);
+					for (int c = 0; c < vcaPostSize; c += 4) {
+						outOutput->setVoltageSimd(simd::float_4::load(&vcaPost[c]), c);
 					}
 				}
 			}
@@ -671,4 +848,4 @@ void Channel::process(bool fsDiv8, ChanCvs *chanCvs) {
 		vcaPostSize = 0;
 		scSignal = 0.0f;
 	}
-}// process
+}// processTail
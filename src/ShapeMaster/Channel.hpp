@@ -14,6 +14,7 @@
 #include "../dsp/ButterworthFilters.hpp"
 #include "PlayHead.hpp"
 #include "Shape.hpp"
+#include "SidechainEngine.hpp"
 
 
 class PresetAndShapeManager;
@@ -95,6 +96,7 @@ class Channel {
 	float nodeTrigDuration = 0.0f;
 	uint8_t gridX = 0;
 	int8_t rangeIndex = 0;
+	int8_t ctrlRateIndex = 0;// index into ctrlRateDivs, 0 is audio rate
 	public:
 	PackedBytes4 channelSettings;
 	PackedBytes4 channelSettings2;
@@ -107,23 +109,31 @@ class Channel {
 	RandomSettings randomSettings;
 	Shape shape;
 	PlayHead playHead;
+	ShapeWavetable* wavetable = nullptr;// not owned, only set for played channels
+	SidechainEngine* scEngine = nullptr;// not owned, only set for played channels
 	
 
 	// no need to save, with reset
 	double sampleTime = 0.0f;
-	LinkwitzRileyStereo8xCrossover xover;
+	LinkwitzRileyPolyCrossover xover;
 	float lastCrossoverParamWithCv = 0.0f;
-	ButterworthFourthOrder hpFilter;
-	ButterworthFourthOrder lpFilter;
 	FirstOrderFilter smoothFilter;
 	float lastSmoothParam = 0.0f;
 	double lastProcessXt = 0.0;
+	double prelastProcessXt = 0.0;
 	bool channelActive = false;
 	int vcaPreSize = 0;
 	int vcaPostSize = 0;
 	float scSignal = 0.0f;// implicitly mono
 	float scEnvelope = 0.0f;// implicitly mono
-	dsp::SlewLimiter scEnvSlewer;
+	bool scEngineInput = false;// scEngine was given this sample's sidechain input in processVcaIn()
+	PolyLookAhead lookAhead;
+	int ctrlRateCounter = -1;// samples until the next control rate eval, negative when the next eval must be a jump
+	bool ctrlRateEval = false;// the shape is evaluated this sample, valid only when ctrlRateIndex != 0
+	bool ctrlRateJump = false;// idem, the play head jumped so the output must jump too
+	double ctrlRateXt = 0.0;// xt after warp and phase (the one the shape is evaluated at), valid only when ctrlRateIndex != 0
+	float ctrlRateCv = 0.0f;// interpolated shape
+	float ctrlRateStep = 0.0f;
 	public:
 	simd::float_4 warpPhaseResponseAmountWithCv;// warp = [0]
 	bool warpPhaseResponseAmountCvConnected = false;
@@ -172,12 +182,12 @@ class Channel {
 		playHead.initRun(withSlowSlew);
 	}
 	
-	json_t* dataToJsonChannel(bool withParams, bool withProUnsyncMatch, bool withFullSettings);
+	json_t* dataToJsonChannel(bool withParams, bool withProUnsyncMatch, bool withFullSettings, bool withBinShape = WITHOUT_BIN_SHAPE);
 	
 	bool dataFromJsonChannel(json_t *channelJ, bool withParams, bool isDirtyCacheLoad, bool withFullSettings, bool inclColAndNameWhenFullSettings = true);
 	
-	json_t* dataToJsonShape() {
-		return shape.dataToJsonShape();
+	json_t* dataToJsonShape(bool withBinShape = WITHOUT_BIN_SHAPE) {
+		return shape.dataToJsonShape(withBinShape);
 	}
 	void dataFromJsonShape(json_t *shapeJ) {
 		shape.dataFromJsonShape(shapeJ);
@@ -208,15 +218,13 @@ class Channel {
 		if (withHistory) {
 			h = new ShapeCompleteChange;
 			h->shapeSrc = &shape;
-			h->oldShape = new Shape();
-			shape.copyShapeTo(h->oldShape);
+			h->captureOld();
 		}
 		
 		shape.randomizeShape(&randomSettings, getGridX(), getRangeIndex(), isDecoupledFirstAndLast());
 		
 		if (withHistory) {
-			h->newShape = new Shape();
-			shape.copyShapeTo(h->newShape);
+			h->captureNew();
 			h->name = "randomise shape";
 			APP->history->push(h);
 		}	
@@ -225,9 +233,11 @@ class Channel {
 
 	void onSampleRateChange() {
 		sampleTime = 1.0 / (double)APP->engine->getSampleRate();
+		lookAhead.setMaxDelay(scLookAheadTimes[NUM_SC_LOOKAHEADS - 1], sampleTime);
 		setCrossoverCutoffFreq();
 		setHPFCutoffSqFreq(hpfCutoffSqFreq);
 		setLPFCutoffSqFreq(lpfCutoffSqFreq);
+		updateScDetector();
 		setSmoothCutoffFreq();
 	}
 	
@@ -242,11 +252,21 @@ class Channel {
 	}
 	void setHPFCutoffSqFreq(float sqfc) {// always use this instead of directly accessing hpfCutoffFreq
 		hpfCutoffSqFreq = sqfc;
-		hpFilter.setParameters(true, std::pow(sqfc, SCF_SCALING_EXP) * APP->engine->getSampleTime());// don't use sampleTime since not ready when called by onReset()
+		if (scEngine) {
+			scEngine->setHpf(chanNum, isHpfCutoffActive(), std::pow(sqfc, SCF_SCALING_EXP) * APP->engine->getSampleTime());// don't use sampleTime since not ready when called by onReset()
+		}
 	}
 	void setLPFCutoffSqFreq(float sqfc) {// always use this instead of directly accessing lpfCutoffFreq
 		lpfCutoffSqFreq = sqfc;
-		lpFilter.setParameters(false, std::pow(sqfc, SCF_SCALING_EXP) * APP->engine->getSampleTime());// don't use sampleTime since not ready when called by onReset()
+		if (scEngine) {
+			scEngine->setLpf(chanNum, isLpfCutoffActive(), std::pow(sqfc, SCF_SCALING_EXP) * APP->engine->getSampleTime());// don't use sampleTime since not ready when called by onReset()
+		}
+	}
+	void updateScDetector() {
+		if (scEngine) {
+			float windowTime = getScDetector() == SCD_RMS ? scRmsWindows[getScRmsWindowIndex()] : 0.0f;
+			scEngine->setRms(chanNum, windowTime, APP->engine->getSampleTime());
+		}
 	}
 	void setSmoothCutoffFreq() {
 		lastSmoothParam = paSmooth->getValue();
@@ -262,7 +282,9 @@ class Channel {
 	void setSensitivity(float _sensitivity) {
 		sensitivity = _sensitivity;
 		float fall = rescale(sensitivity, SENSITIVITY_MIN, SENSITIVITY_MAX, 5.0f, 50.0f);
-		scEnvSlewer.setRiseFall(1000.0f, fall);
+		if (scEngine) {
+			scEngine->setEnvelopeRiseFall(chanNum, 1000.0f, fall);
+		}
 	}
 	void setGainAdjustVca(float _gainAdjust) {;
 		gainAdjustVca = _gainAdjust;// this is a gain here (not dB)
@@ -281,6 +303,9 @@ class Channel {
 	}
 	void setTrigMode(int8_t _trigMode) {
 		playHead.setTrigMode(_trigMode);
+		if (_trigMode == TM_OSC && wavetable) {
+			wavetable->startRenderer();
+		}
 	}
 	void setLoopStart(float _val) {
 		playHead.setLoopStart(_val);
@@ -497,12 +522,24 @@ class Channel {
 	bool isForced0VWhenStopped() {
 		return channelSettings4.cc4[0] != 0;
 	}
+	int8_t getCtrlRateIndex() {
+		return ctrlRateIndex;
+	}
 	int8_t getPolyMode() {
 		return channelSettings.cc4[2];
 	}
 	bool isSidechainUseVca() {
 		return channelSettings.cc4[3] != 0;
 	}
+	int8_t getScDetector() {
+		return channelSettings4.cc4[1];
+	}
+	int8_t getScRmsWindowIndex() {
+		return channelSettings4.cc4[2];
+	}
+	int8_t getScLookAheadIndex() {
+		return channelSettings4.cc4[3];
+	}
 	std::string getPresetPath() {
 		return presetPath;
 	}
@@ -515,9 +552,24 @@ class Channel {
 	RandomSettings* getRandomSettings() {
 		return &randomSettings;
 	}
+	void enableWavetable(ShapeWavetable* _wavetable) {
+		wavetable = _wavetable;
+		shape.setWavetable(_wavetable);
+	}
+	void enableSidechainEngine(SidechainEngine* _scEngine) {
+		scEngine = _scEngine;
+		scEngine->reset(chanNum);
+		setHPFCutoffSqFreq(hpfCutoffSqFreq);
+		setLPFCutoffSqFreq(lpfCutoffSqFreq);
+		setSensitivity(sensitivity);
+		updateScDetector();
+	}
 	Shape* getShape() {
 		return &shape;
 	}
+	simd::float_4 getWarpPhaseResponseAmountWithCv() {
+		return warpPhaseResponseAmountWithCv;
+	}
 	PlayHead* getPlayHead() {
 		return &playHead;
 	}
@@ -547,7 +599,7 @@ class Channel {
 	std::string getLengthText(bool* inactive);
 
 	std::string getRepetitionsText(bool* inactive) {
-		*inactive = (playHead.getTrigMode() == TM_CV);
+		*inactive = (playHead.getTrigMode() == TM_CV || playHead.getTrigMode() == TM_OSC);
 		int reps = getRepetitions();
 		if (reps >= (int)PlayHead::INF_REPS) {
 			return "INF";
@@ -561,7 +613,7 @@ class Channel {
 	}
 	
 	std::string getSwingText(bool* inactive) {
-		*inactive = playHead.getTrigMode() == TM_CV;
+		*inactive = (playHead.getTrigMode() == TM_CV || playHead.getTrigMode() == TM_OSC);
 		std::string ret = string::f("%.1f%%", playHead.getSwing() * 100.0f);
 		return ret == "-0.0%" ? "0.0%" : ret;
 	}
@@ -693,6 +745,9 @@ class Channel {
 		if (!*running) {
 			return -1.0f;
 		}
+		if (playHead.getTrigMode() == TM_OSC) {
+			return -1.0f;// audio rate
+		}
 		if (playHead.getTrigMode() != TM_CV) {
 			if (playHead.getPlayMode() == PM_REV) {
 				if (lastProcessXt == 1.0f) {
@@ -707,7 +762,7 @@ class Channel {
 	}
 	float getScopePosition() {
 		// returns -1.0f when no scope to display
-		if (!*running) {
+		if (!*running || playHead.getTrigMode() == TM_OSC) {
 			return -1.0f;
 		}
 		return (float)lastProcessXt;
@@ -737,6 +792,21 @@ class Channel {
 	void toggleForced0VWhenStopped() {
 		channelSettings4.cc4[0] ^= 0x1;
 	}
+	void setScDetector(int8_t detector) {
+		channelSettings4.cc4[1] = detector;
+		updateScDetector();
+	}
+	void setScRmsWindowIndex(int8_t windowIndex) {
+		channelSettings4.cc4[2] = windowIndex;
+		updateScDetector();
+	}
+	void setScLookAheadIndex(int8_t lookAheadIndex) {
+		channelSettings4.cc4[3] = lookAheadIndex;
+	}
+	void setCtrlRateIndex(int8_t _ctrlRateIndex) {
+		ctrlRateIndex = _ctrlRateIndex;
+		ctrlRateCounter = -1;// eval and jump on next sample
+	}
 	
 	int getVcaPreSize() {
 		return vcaPreSize;
@@ -764,12 +834,14 @@ class Channel {
 	// --------
 
 
-	// Comparison for dirty
+	// Comparison for dirty (a channel is dirty when its hash differs from the hash of the preset or shape file it was loaded from)
 	
-	bool isDirty(Channel* refChan);
+	uint64_t calcDirtyHash();
 	
-	bool isDirtyShape(Channel* refChan) {
-		return shape.isDirty(&(refChan->shape));
+	uint64_t calcDirtyHashShape() {
+		DirtyHash dh;
+		shape.addToDirtyHash(&dh);
+		return dh.hash;
 	}
 
 
@@ -802,7 +874,7 @@ class Channel {
 		}
 		
 		c += (T)1.0;
-		T _y = _x * std::pow(c, (T)2.0 * ((T)1.0 - _x));
+		T _y = _x * curvePow(c, (T)2.0 * ((T)1.0 - _x));
 	
 		if (mirror) {
 			_y = (T)1.0 - _y;
@@ -898,17 +970,28 @@ class Channel {
 	// --------------------
 
 
-	float evalShapeForProcess(double xt) {
-		xt = applyWarp<double>(xt);
-		xt = applyPhase<double>(xt);
-		
-		float cvVal = shape.evalShapeForProcess(xt);
-		
-		cvVal = applyResponse(cvVal);
-		cvVal = applyAmount(cvVal);
-		cvVal = applySlewAndSmooth(cvVal);
-		
-		return cvVal;
+	static simd::float_4 curveFactorSimd(simd::float_4 _x, simd::float_4 c) {
+		// the (c+1)^(2(1-x)) factor of _y() above, for the already mirrored _x, where c is the unmirrored c
+		return curvePow(1.0f - simd::fabs(c), 2.0f * (1.0f - _x));
+	}
+	
+	double applyWarpAndPhaseForProcess(double xt) {
+		// scalar version of the warp and phase in evalShapesForProcess(), so that it finds the same segments
+		float warp = -warpPhaseResponseAmountWithCv[0];
+		xt = std::fmin(xt, 1.0);
+		float u = (float)(warp > 0.0f ? 1.0 - xt : xt);
+		double warpFactor = (double)curvePow(1.0f - std::fabs(warp), 2.0f * (1.0f - u));
+		if (warp > 0.0f) {
+			xt = 1.0 - (1.0 - xt) * warpFactor;
+		}
+		else {
+			xt *= warpFactor;
+		}
+		return applyPhase<double>(xt);
+	}
+	
+	bool isCvForcedTo0V() {
+		return isForced0VWhenStopped() && getTrigMode() != TM_CV && getTrigMode() != TM_OSC && playHead.getState() == PlayHead::STOPPED;
 	}
 
 
@@ -942,6 +1025,16 @@ class Channel {
 	void processSlow(ChanCvs *chanCvs);
 	
 
-	void process(bool fsDiv8, ChanCvs *chanCvs);
+	bool processHead(bool fsDiv8, ChanCvs *chanCvs);
+	
+	static void evalShapesForProcess(Channel* channels, const bool* needsEval, float* shapeCvs);// channels must point to 8 channels
+	
+	bool processCtrlRateHead();
+	
+	float processCtrlRateTail(float shapeCv);
+	
+	void processVcaIn();
+	
+	void processTail(float shapeCv);
 
 };// class Channel
@@ -30,6 +30,13 @@ class ClockDetector {
 	int32_t clockSampleMem[CLOCK_MEM_MAX];
 	int clockSampleMemHead;
 	bool clockEdgeDetected;
+	// edge tracking, in samples since reset, with sub-sample edge times
+	double sampleCount;
+	double lastEdgeTime;
+	int32_t numEdges;// since reset
+	// delay-locked loop (second order) on the edge times, see F. Adriaensen, "Using a DLL to filter time"
+	double dllNextEdge;// predicted time of the next edge
+	double dllPeriod;// filtered pulse period in samples
 	
 	
 	public:
@@ -62,6 +69,11 @@ class ClockDetector {
 		clockSampleMemHead = ppqnAvg - 1;// will start counting anew in last bin
 		clockSampleMem[clockSampleMemHead] = 0;
 		clockEdgeDetected = false;
+		sampleCount = 0.0;
+		lastEdgeTime = 0.0;
+		numEdges = 0;
+		dllPeriod = clockPeriodSynced * (double)sampleRate / (double)ppqn;
+		dllNextEdge = dllPeriod;
 	}
 	
 	void dataToJson(json_t* rootJ) {
@@ -153,7 +165,10 @@ class ClockDetector {
 	
 	
 	double timeSinceLastPulse() {
-		return sampleTime * (double)samplesSinceLastPulse();
+		if (numEdges == 0) {
+			return sampleTime * (double)samplesSinceLastPulse();
+		}
+		return sampleTime * (sampleCount - lastEdgeTime);// sub-sample accurate
 	}
 	
 	
@@ -162,18 +177,53 @@ class ClockDetector {
 	}
 	
 	
-	void process(bool edgeDetected) {
+	static float calcEdgeFrac(float lastVoltage, float voltage) {
+		// when a dsp::SchmittTrigger (high threshold of 1V) fires, returns how far back in the last sample
+		//   interval the input crossed the threshold, by linear interpolation, in [0 : 1[
+		if (voltage <= lastVoltage) {
+			return 0.0f;
+		}
+		return clamp((voltage - 1.0f) / (voltage - lastVoltage), 0.0f, 0.999f);
+	}
+	
+	
+	void process(bool edgeDetected, float edgeFrac = 0.0f) {
 		// edgeDetected can only be true when running (includes initial when run activated)
+		// edgeFrac: see calcEdgeFrac(), only used when edgeDetected
 		if (edgeDetected) {
 			clockCount++;
 			clockSampleTotal += clockSampleMem[clockSampleMemHead];
-			clockPeriodSynced = ( (double)(clockSampleTotal * ppqn * sampleTime) ) / ( (double)ppqnAvg );
+			
+			// the period tracks the edges with a DLL instead of a moving average over ppqnAvg pulses, where ppqnAvg now sets 
+			//   the loop bandwidth (omega = 1/ppqnAvg rad per pulse, damping of 0.707)
+			// errors of more than 2% of a period use a wider loop (omega = 0.5) to lock faster on tempo changes, and errors 
+			//   of more than 1/8 of a period (tempo jump, missed or extra pulse) relock on the last interval
+			double edgeTime = sampleCount - (double)edgeFrac;
+			if (numEdges == 0) {
+				dllNextEdge = edgeTime + dllPeriod;
+			}
+			else {
+				double err = edgeTime - dllNextEdge;
+				if (std::fabs(err) > 0.125 * dllPeriod) {
+					dllPeriod = std::max(edgeTime - lastEdgeTime, 1.0);
+					dllNextEdge = edgeTime + dllPeriod;
+				}
+				else {
+					double omega = std::fabs(err) > 0.02 * dllPeriod ? 0.5 : 1.0 / (double)ppqnAvg;
+					dllNextEdge += omega * M_SQRT2 * err + dllPeriod;
+					dllPeriod += omega * omega * err;
+				}
+			}
+			lastEdgeTime = edgeTime;
+			numEdges++;
+			clockPeriodSynced = dllPeriod * (double)ppqn * sampleTime;
 			// DEBUG("%i: bpm = %g %i", clockCount, 60.0f / clockPeriodSynced, clockSampleTotal);
 			clockSampleMemHead = (clockSampleMemHead + 1) % ppqnAvg;
 			clockSampleTotal -= clockSampleMem[clockSampleMemHead];
 			clockSampleMem[clockSampleMemHead] = 0;
 		}
 		clockSampleMem[clockSampleMemHead]++;
+		sampleCount += 1.0;
 		if (clockSampleMem[clockSampleMemHead] > (int32_t)(sampleRate) * 2l) {// timeout 30 BPM (2s) on clock pulses, so at 4 ppqn this is 7.5 BPM
 			resetClockDetector();
 		}
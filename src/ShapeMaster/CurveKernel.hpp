@@ -0,0 +1,107 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include "rack.hpp"
+
+using namespace rack;
+
+
+// Fast exp2() and log2() for the curve family y(x) := x*b^(2(1-x)) used by Shape::_y(), Channel::_y()
+//   and the compiled shape segments, where the base b is within (0 : 2] (b = 2c or b = c+1)
+// Bounds (offline sweep of c within [MIN_CTRL : 1-MIN_CTRL] and x within [0 : 1] against std::pow in double):
+//   fastExp2: relative error < 3e-7 for x within [-126 : 126]
+//   fastLog2: absolute error < 2e-7 plus the float rounding of the result (1e-6 at b = 2*MIN_CTRL)
+//   curvePow: absolute error on y < 1e-6 (all y are within [0 : 1])
+
+
+// exp2(x) = 2^i * 2^f with i = round(x) and f within [-0.5 : 0.5], where 2^f is a degree 6 Taylor polynomial
+//   (its coefficients are ln(2)^n / n!), exact for x = 0.0f so that b = 1 (c = 0) gives a linear curve
+
+static inline float fastExp2Poly(float f) {
+	return 1.0f + f * (0.69314718f + f * (0.24022651f + f * (0.055504109f + f * (0.0096181291f + f * (0.0013333558f + f * 0.00015403530f)))));
+}
+
+static inline simd::float_4 fastExp2Poly(simd::float_4 f) {
+	return 1.0f + f * (0.69314718f + f * (0.24022651f + f * (0.055504109f + f * (0.0096181291f + f * (0.0013333558f + f * 0.00015403530f)))));
+}
+
+
+static inline float fastExp2(float x) {
+	x = clamp(x, -126.0f, 126.0f);
+	float xi = std::floor(x + 0.5f);
+	int32_t scaleBits = ((int32_t)xi + 127) << 23;
+	float scale;
+	std::memcpy(&scale, &scaleBits, sizeof(float));
+	return fastExp2Poly(x - xi) * scale;
+}
+
+static inline simd::float_4 fastExp2(simd::float_4 x) {
+	x = simd::clamp(x, -126.0f, 126.0f);
+	__m128i xi = _mm_cvtps_epi32(x.v);// round to nearest
+	simd::float_4 f = x - simd::float_4(_mm_cvtepi32_ps(xi));
+	simd::float_4 scale = simd::float_4(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(xi, _mm_set1_epi32(127)), 23)));
+	return fastExp2Poly(f) * scale;
+}
+
+
+// log2(x) = e + log2(m) with m within [sqrt(0.5) : sqrt(2)], where log2(m) = 2/ln(2) * atanh(s) and s = (m-1)/(m+1)
+//   is within [-0.172 : 0.172], such that four terms of the atanh series are enough
+// assumes x > 0 and not denormal
+
+static inline float fastLog2Series(float s) {
+	float s2 = s * s;
+	return s * (2.8853901f + s2 * (0.96179670f + s2 * (0.57707802f + s2 * 0.41219858f)));
+}
+
+static inline simd::float_4 fastLog2Series(simd::float_4 s) {
+	simd::float_4 s2 = s * s;
+	return s * (2.8853901f + s2 * (0.96179670f + s2 * (0.57707802f + s2 * 0.41219858f)));
+}
+
+
+static inline float fastLog2(float x) {
+	int32_t bits;
+	std::memcpy(&bits, &x, sizeof(float));
+	float e = (float)((bits >> 23) - 127);
+	bits = (bits & 0x007FFFFF) | 0x3F800000;
+	float m;
+	std::memcpy(&m, &bits, sizeof(float));
+	if (m > 1.41421356f) {
+		m *= 0.5f;
+		e += 1.0f;
+	}
+	return e + fastLog2Series((m - 1.0f) / (m + 1.0f));
+}
+
+static inline simd::float_4 fastLog2(simd::float_4 x) {
+	__m128i bits = _mm_castps_si128(x.v);
+	simd::float_4 e = simd::float_4(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127))));
+	simd::float_4 m = simd::float_4(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000))));
+	simd::float_4 isHigh = m > 1.41421356f;
+	m = simd::ifelse(isHigh, m * 0.5f, m);
+	e += simd::ifelse(isHigh, 1.0f, 0.0f);
+	return e + fastLog2Series((m - 1.0f) / (m + 1.0f));
+}
+
+
+// b^e for the curve family above, b within (0 : 2]
+// the double version is left exact since it is only used where the x resolution matters more than speed
+
+static inline float curvePow(float b, float e) {
+	return fastExp2(e * fastLog2(b));
+}
+
+static inline double curvePow(double b, double e) {
+	return std::pow(b, e);
+}
+
+static inline simd::float_4 curvePow(simd::float_4 b, simd::float_4 e) {
+	return fastExp2(e * fastLog2(b));
+}
@@ -0,0 +1,38 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+
+// Content hash for the preset and shape dirty detection (FNV-1a, 64 bits)
+// Values must be added in the form they are compared in, i.e. rounded to the resolution that matters
+//   (for example std::round(percent * 10.0f) for a percent to one decimal) or as the text that is shown
+struct DirtyHash {
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	void add(int64_t val) {
+		for (int i = 0; i < 8; i++) {
+			hash ^= (uint64_t)((val >> (i * 8)) & 0xFF);
+			hash *= 0x100000001b3ULL;
+		}
+	}
+	void addRounded(float val) {
+		add((int64_t)std::round(val));
+	}
+	void add(const std::string& text) {
+		for (unsigned char ch : text) {
+			hash ^= (uint64_t)ch;
+			hash *= 0x100000001b3ULL;
+		}
+		add((int64_t)text.size());// so that the texts of consecutive adds can't be shifted into each other
+	}
+};
@@ -199,8 +199,7 @@ void ShapeMasterDisplay::onDragStart(const event::DragStart& e) {
 				// Push ShapeCompleteChange history action (rest is done in onDragEnd())
 				dragHistoryStep = new ShapeCompleteChange;
 				dragHistoryStep->shapeSrc = shape;
-				dragHistoryStep->oldShape = new Shape();
-				shape->copyShapeTo(dragHistoryStep->oldShape);
+				dragHistoryStep->captureOld();
 			}
 		}
 	}// if left button && not cloaked
@@ -286,8 +285,7 @@ void ShapeMasterDisplay::onDragEnd(const event::DragEnd& e) {
 	
 	// history
 	if (dragHistoryStep != NULL) {
-		dragHistoryStep->newShape = new Shape();
-		shape->copyShapeTo(dragHistoryStep->newShape);
+		dragHistoryStep->captureNew();
 		dragHistoryStep->name = "add/move step";
 		APP->history->push(dragHistoryStep);
 		dragHistoryStep = NULL;
@@ -30,7 +30,7 @@ struct ShapeMasterDisplayLight : TransparentWidget {
 	float* lineWidthSrc = nullptr;
 	int* dragPtSelect = nullptr;// from ShapeMasterDisplay
 	int* hoverPtSelect = nullptr;// from ShapeMasterDisplay
-	ScopeBuffers* scopeBuffers = nullptr;	
+	ScopeEngine* scopeEngine = nullptr;	
 	
 
 	// internal
@@ -39,6 +39,15 @@ struct ShapeMasterDisplayLight : TransparentWidget {
 	std::shared_ptr<Font> font;
 	std::string fontPath;
 	float shaY[SHAPE_PTS + 1] = {};// points of the shadow curve, with an extra element for last end point
+	// the shadow and the lines of the shape are only recalculated when the shape is edited, when warp/phase/response/amount
+	//   change (shadow only) or when the canvas is resized (lines only), other frames redraw the cached geometry
+	Shape* shaShape = nullptr;// shape and version that shaY[] was calculated for
+	uint32_t shaEditCount = 0;
+	simd::float_4 shaWarpPhaseResponseAmount = 0.0f;
+	Shape* lineShape = nullptr;// shape and version that linePts was calculated for
+	uint32_t lineEditCount = 0;
+	Vec lineCanvas;
+	std::vector<Vec> linePts;// in pixels
 	int numGridXmajorX = 0;
 	float gridXmajorX[16] = {};
 
@@ -105,10 +114,13 @@ struct ShapeMasterDisplayLight : TransparentWidget {
 
 	void drawGrid(const DrawArgs &args); 
 
-	void drawScopeWaveform(const DrawArgs &args, bool isFront);
+	void drawScopeWaveform(const DrawArgs &args, int c, bool isFront);
+	void drawScopeRms(const DrawArgs &args, int c);
 	void drawScope(const DrawArgs &args);
 
 	void drawShapeWhenModuleIsVoid(const DrawArgs &args);
+	void updateShadowCache();
+	void updateLineCache();
 	void drawShape(const DrawArgs &args);
 
 	void drawMessages(const DrawArgs &args);
@@ -63,27 +63,29 @@ void ShapeMasterDisplayLight::drawGrid(const DrawArgs &args) {
 }
 
 
-void ShapeMasterDisplayLight::drawScopeWaveform(const DrawArgs &args, bool isFront) {
-	float* drawBufMin = isFront ? scopeBuffers->scpFrontYmin : scopeBuffers->scpBackYmin;
-	float* drawBufMax = isFront ? scopeBuffers->scpFrontYmax : scopeBuffers->scpBackYmax;
+void ShapeMasterDisplayLight::drawScopeWaveform(const DrawArgs &args, int c, bool isFront) {
+	const ScopeEngine::Bin* bins = scopeEngine->getBins(c);
+	int numPts = scopeEngine->getNumPts();
 	
 	nvgBeginPath(args.vg);
-	float dsx = 1.0f / ((float)ScopeBuffers::SCOPE_PTS);// in normalized space
+	float dsx = 1.0f / ((float)numPts);// in normalized space
 	float sx = 0.0f;
 	float sy = 0.5f;
-	if (scopeBuffers->isDrawPoint(0)) {
-		sy = clamp(0.5f - drawBufMin[0] * 0.05f, 0.0f, 1.0f);
+	if (scopeEngine->isDrawPoint(c, 0)) {
+		sy = clamp(0.5f - (isFront ? bins[0].frontMin : bins[0].backMin) * 0.05f, 0.0f, 1.0f);
 	}
 	sy = margins.y + sy * canvas.y;
 	nvgMoveTo(args.vg, margins.x + sx * canvas.x, sy);
 	bool yOnMin = true;
-	for (int i = 0; i <= ScopeBuffers::SCOPE_PTS; i++) {
-		if (scopeBuffers->isDrawPoint(i)) {
-			sy = yOnMin ? drawBufMax[i] : drawBufMin[i];
+	for (int i = 0; i <= numPts; i++) {
+		if (scopeEngine->isDrawPoint(c, i)) {
+			float binMin = isFront ? bins[i].frontMin : bins[i].backMin;
+			float binMax = isFront ? bins[i].frontMax : bins[i].backMax;
+			sy = yOnMin ? binMax : binMin;
 			sy = margins.y + clamp(0.5f - sy * 0.05f, 0.0f, 1.0f) * canvas.y;
 			nvgLineTo(args.vg, margins.x + sx * canvas.x, sy);
-			if (drawBufMin[i] != drawBufMax[i]) {
-				float sy2 = yOnMin ? drawBufMin[i] : drawBufMax[i];
+			if (binMin != binMax) {
+				float sy2 = yOnMin ? binMin : binMax;
 				sy2 = margins.y + clamp(0.5f - sy2 * 0.05f, 0.0f, 1.0f) * canvas.y;
 				nvgLineTo(args.vg, margins.x + sx * canvas.x, sy2);
 			}
@@ -101,27 +103,69 @@ void ShapeMasterDisplayLight::drawScopeWaveform(const DrawArgs &args, bool isFro
 }
 
 
+void ShapeMasterDisplayLight::drawScopeRms(const DrawArgs &args, int c) {
+	// front trace of a channel other than the current one, as a single RMS line so that the overlay stays readable
+	const ScopeEngine::Bin* bins = scopeEngine->getBins(c);
+	int numPts = scopeEngine->getNumPts();
+	
+	nvgBeginPath(args.vg);
+	float dsx = 1.0f / ((float)numPts);// in normalized space
+	float sx = 0.0f;
+	bool penDown = false;
+	for (int i = 0; i <= numPts; i++) {
+		if (scopeEngine->isDrawPoint(c, i)) {
+			float sy = margins.y + clamp(0.5f - bins[i].frontRms * 0.05f, 0.0f, 1.0f) * canvas.y;
+			if (penDown) {
+				nvgLineTo(args.vg, margins.x + sx * canvas.x, sy);
+			}
+			else {
+				nvgMoveTo(args.vg, margins.x + sx * canvas.x, sy);
+				penDown = true;
+			}
+		}
+		else {
+			penDown = false;
+		}
+		sx += dsx;
+	}
+	nvgStroke(args.vg);		
+}
+
+
 void ShapeMasterDisplayLight::drawScope(const DrawArgs &args) {
-	if (scopeBuffers->scopeOn) {
+	scopeEngine->drain(APP->engine->getSampleRate());
+	
+	// other channels (only captured when the scope shows all channels)
+	nvgStrokeWidth(args.vg, 1.0f);
+	nvgMiterLimit(args.vg, 1.0f);
+	for (int c = 0; c < 8; c++) {
+		if (c != *currChan && scopeEngine->traceOn[c]) {
+			nvgStrokeColor(args.vg, nvgTransRGBAf(CHAN_COLORS[channels[c].channelSettings.cc4[1]], 0.3f));
+			drawScopeRms(args, c);
+		}
+	}
+	
+	// current channel
+	if (scopeEngine->traceOn[*currChan]) {
 		nvgStrokeWidth(args.vg, 1.0f);
 		nvgMiterLimit(args.vg, 1.0f);
-		if (scopeBuffers->scopeVca) {			
-			// VCA PRE - draw scpBackY
+		if (scopeEngine->scopeVca) {			
+			// VCA PRE - draw back trace
 			nvgStrokeColor(args.vg, DARK_GRAY);
-			drawScopeWaveform(args, false);
+			drawScopeWaveform(args, *currChan, false);
 			
-			// VCA POST - draw scpFrontY
+			// VCA POST - draw front trace
 			nvgStrokeColor(args.vg, MID_DARKER_GRAY);
-			drawScopeWaveform(args, true);
+			drawScopeWaveform(args, *currChan, true);
 		}
 		else {
-			// SC AUDIO - draw scpBackY
+			// SC AUDIO - draw back trace
 			nvgStrokeColor(args.vg, DARK_GRAY);
-			drawScopeWaveform(args, false);
+			drawScopeWaveform(args, *currChan, false);
 			
-			// SC ENV - draw scpFrontY
+			// SC ENV - draw front trace
 			nvgStrokeColor(args.vg, MID_DARKER_GRAY);
-			drawScopeWaveform(args, true);
+			drawScopeWaveform(args, *currChan, true);
 
 			// SC TRIG LEVEL
 			nvgStrokeColor(args.vg, MID_GRAY);
@@ -189,6 +233,58 @@ void ShapeMasterDisplayLight::drawShapeWhenModuleIsVoid(const DrawArgs &args) {
 	nvgFill(args.vg);	
 }
 
+void ShapeMasterDisplayLight::updateShadowCache() {
+	Shape* shape = channels[*currChan].getShape();
+	uint32_t editCount = shape->getEditCount();// read before the shape, so that an edit that ends during the update is seen next time
+	simd::float_4 wpra = channels[*currChan].getWarpPhaseResponseAmountWithCv();
+	if (shape == shaShape && editCount == shaEditCount && simd::movemask(wpra != shaWarpPhaseResponseAmount) == 0) {
+		return;
+	}
+	shaShape = shape;
+	shaEditCount = editCount;
+	shaWarpPhaseResponseAmount = wpra;
+	
+	int epc = 0;
+	float dsx = 1.0f / ((float)SHAPE_PTS);// in normalized space
+	float sx = 0.0f;
+	for (int i = 0; i < SHAPE_PTS; i++) {
+		shaY[i] = channels[*currChan].evalShapeForShadow(sx, &epc);
+		sx += dsx;
+	}
+	shaY[SHAPE_PTS] = channels[*currChan].evalShapeForShadow(1.0f, &epc);// [SHAPE_PTS] not an error since the array was declared with room for last point
+}
+
+
+void ShapeMasterDisplayLight::updateLineCache() {
+	Shape* shape = channels[*currChan].getShape();
+	uint32_t editCount = shape->getEditCount();// see updateShadowCache()
+	if (shape == lineShape && editCount == lineEditCount && canvas.x == lineCanvas.x && canvas.y == lineCanvas.y && !linePts.empty()) {
+		return;
+	}
+	lineShape = shape;
+	lineEditCount = editCount;
+	lineCanvas = canvas;
+	
+	linePts.clear();
+	linePts.push_back(Vec(margins.x, shape->getPointYFlip(0) * canvas.y + margins.y));
+	int numPts = shape->getNumPts();
+	for (int pt = 0; pt < (numPts - 1); pt++) {
+		Vec nextPoint = (shape->getPointVectFlipY(pt + 1).mult(canvas)).plus(margins);
+		if (!shape->isLinear(pt)) {
+			float stepX = 0.003f;// in normalized space
+			if (shape->getCtrl(pt) > 0.9f || shape->getCtrl(pt) < 0.1f) {
+				stepX /= 2.0f;
+			}
+			float dx = shape->getPointX(pt + 1) - shape->getPointX(pt);// in normalized space
+			for (float _x = stepX; _x < dx; _x += stepX) {// _x normalized and relative to point pt
+				linePts.push_back((shape->getPointVectFlipY(pt, _x).mult(canvas)).plus(margins));
+			}					
+		}
+		linePts.push_back(nextPoint);// just in case over/under-shoot in loop above, when not linear
+	}
+}
+
+
 void ShapeMasterDisplayLight::drawShape(const DrawArgs &args) {
 	Shape* shape = channels[*currChan].getShape();
 	
@@ -221,19 +317,17 @@ void ShapeMasterDisplayLight::drawShape(const DrawArgs &args) {
 		homeY = margins.y - 0.5f;			
 	}
 	nvgFillColor(args.vg, shadowColBright);
-	int epc = 0;
+	updateShadowCache();
 	float dsx = 1.0f / ((float)SHAPE_PTS);// in normalized space
 	float sx = 0.0f;
 	nvgBeginPath(args.vg);
 	nvgMoveTo(args.vg, margins.x, homeY);
 	for (int i = 0; i < SHAPE_PTS; i++) {
-		shaY[i] = channels[*currChan].evalShapeForShadow(sx, &epc);
 		float sy = 1.0f - shaY[i];
 		sy = margins.y + sy * canvas.y;
 		nvgLineTo(args.vg, margins.x + sx * canvas.x, sy);
 		sx += dsx;
 	}
-	shaY[SHAPE_PTS] = channels[*currChan].evalShapeForShadow(1.0f, &epc);// [SHAPE_PTS] not an error since the array was declared with room for last point
 	float sy = 1.0f - shaY[SHAPE_PTS];
 	sy = margins.y + sy * canvas.y;
 	nvgLineTo(args.vg, margins.x + canvas.x, sy);
@@ -246,25 +340,11 @@ void ShapeMasterDisplayLight::drawShape(const DrawArgs &args) {
 	// lines
 	nvgStrokeColor(args.vg, chanColor);
 	nvgFillColor(args.vg, chanColor);
+	updateLineCache();
 	nvgBeginPath(args.vg);
-	nvgMoveTo(args.vg, margins.x, shape->getPointYFlip(0) * canvas.y + margins.y);
-	for (int pt = 0; pt < (numPts - 1); pt++) {
-		Vec nextPoint = (shape->getPointVectFlipY(pt + 1).mult(canvas)).plus(margins);
-		if (shape->isLinear(pt)) {
-			nvgLineTo(args.vg, nextPoint.x, nextPoint.y);
-		}
-		else {
-			float stepX = 0.003f;// in normalized space
-			if (shape->getCtrl(pt) > 0.9f || shape->getCtrl(pt) < 0.1f) {
-				stepX /= 2.0f;
-			}
-			float dx = shape->getPointX(pt + 1) - shape->getPointX(pt);// in normalized space
-			for (float _x = stepX; _x < dx; _x += stepX) {// _x normalized and relative to point pt
-				Vec point1 = (shape->getPointVectFlipY(pt, _x).mult(canvas)).plus(margins);
-				nvgLineTo(args.vg, point1.x, point1.y);
-			}					
-			nvgLineTo(args.vg, nextPoint.x, nextPoint.y);// just in case over/under-shoot in loop above
-		}
+	nvgMoveTo(args.vg, linePts[0].x, linePts[0].y);
+	for (size_t i = 1; i < linePts.size(); i++) {
+		nvgLineTo(args.vg, linePts[i].x, linePts[i].y);
 	}
 	nvgStroke(args.vg);
 	
@@ -379,7 +459,7 @@ void ShapeMasterDisplayLight::drawShape(const DrawArgs &args) {
 	// play head
 	nvgStrokeWidth(args.vg, 1.0f);
 	float playHead = channels[*currChan].getPlayHeadPosition();
-	epc = 0;
+	int epc = 0;
 	if (playHead != -1.0f) {
 		// vertical line
 		nvgBeginPath(args.vg);
@@ -9,87 +9,231 @@
 #include "DisplayUtil.hpp"
 
 
-void ScopeBuffers::populate(Channel* channel, int8_t scopeSettings) {
+static void getScopeValues(Channel* channel, bool scopeVca, float* frontVal, float* backVal) {
+	if (scopeVca) {
+		int8_t polySelect = channel->channelSettings2.cc4[0];
+		
+		// VcaPost
+		int postSize = channel->getVcaPostSize();
+		if (polySelect < 16 && postSize > polySelect) {
+			*frontVal = channel->getVcaPost(polySelect);
+		}
+		else if (polySelect == 16 && postSize > 0) {
+			*frontVal = channel->getVcaPost(0);
+			if (postSize > 1) {
+				*frontVal = (*frontVal + channel->getVcaPost(1)) * 0.5f;
+			}
+		}
+		else {
+			*frontVal = 0.0f;
+		}
+		
+		// VcaPre
+		int preSize = channel->getVcaPreSize();
+		if (polySelect < 16 && preSize > polySelect) {
+			*backVal = channel->getVcaPre(polySelect);
+		}
+		else if (polySelect == 16 && preSize > 0) {
+			*backVal = channel->getVcaPre(0);
+			if (preSize > 1) {
+				*backVal = (*backVal + channel->getVcaPre(1)) * 0.5f;
+			}
+		}
+		else {
+			*backVal = 0.0f;
+		}
+	}
+	else {
+		*frontVal = channel->getScEnvelope();
+		*backVal = channel->getScSignal();			
+	}
+}
+
+
+void ScopeEngine::capture(Channel* channels, int currChan, int8_t scopeSettings, int8_t resIndex) {
+	RecordRing* newRing = uiRing.load(std::memory_order_acquire);
+	if (newRing != ring) {
+		// the UI resized the ring, the old one is no longer used from here on
+		ring = newRing;
+		audioRing.store(newRing, std::memory_order_release);
+		for (int c = 0; c < 8; c++) {
+			captures[c].active = false;// will clear the traces, since what was left in the old ring is not drawn
+		}
+	}
+	if (resIndex != lastResIndex) {
+		lastResIndex = resIndex;
+		for (int c = 0; c < 8; c++) {
+			captures[c].active = false;// will clear the traces, which the UI also does when it sees the new resolution
+		}
+	}
+	scopeVca = ((scopeSettings & SCOPE_MASK_VCA_nSC) != 0);
+	bool scopeOn = ((scopeSettings & SCOPE_MASK_ON) != 0);
+	bool overlay = scopeOn && ((scopeSettings & SCOPE_MASK_OVERLAY) != 0);
+	for (int c = 0; c < 8; c++) {
+		if (scopeOn && (c == currChan || overlay)) {
+			captured[c] = true;
+			captureChannel(c, &channels[c], scopeSettings, resIndex);
+		}
+		else {
+			captures[c].active = false;
+			captured[c] = false;
+			traceOn[c] = false;
+		}
+	}
+}
+
+
+void ScopeEngine::captureChannel(int c, Channel* channel, int8_t scopeSettings, int8_t resIndex) {
+	Capture* cap = &captures[c];
 	int newState = channel->getState();
 	int8_t newTrigMode = channel->getTrigMode();
-	bool needClear = (lastChannel != channel) || (newState == PlayHead::STEPPING && lastState == PlayHead::STOPPED) || lastTrigMode != newTrigMode;
-	if (needClear) {
-		lastChannel = channel;
-		lastTrigMode = newTrigMode;
-		clear();
+	if (!cap->active || (newState == PlayHead::STEPPING && cap->lastState == PlayHead::STOPPED) || cap->lastTrigMode != newTrigMode) {
+		cap->active = true;
+		cap->lastTrigMode = newTrigMode;
+		cap->bin = -1;
+		cap->needClear = true;
+	}
+	cap->lastState = newState;// must be outside since newState can be different from lastState but not have triggered a clear
+	if (cap->needClear && ring != nullptr && !ring->full()) {
+		Record rec = {};
+		rec.chan = c;
+		rec.resIndex = resIndex;
+		rec.bin = -1;
+		ring->push(rec);
+		cap->needClear = false;
 	}
-	lastState = newState;// must be outside since newState can be different from lastState but not have triggered a clear
 	
 	float scpIf = channel->getScopePosition();
 	if (scpIf != -1.0f && channel->getChannelActive() && (scopeSettings & SCOPE_MASK_ON) != 0) {
-		scopeOn = true;
-		scopeVca = ((scopeSettings & SCOPE_MASK_VCA_nSC) != 0);
+		traceOn[c] = true;
 		if (newState == PlayHead::STEPPING) {
-			int scpI = (int)(scpIf * SCOPE_PTS + 0.5f);
-			setPoint(scpI);
+			int bin = (int)(scpIf * scopeResPts[resIndex] + 0.5f);
 			float frontVal;
 			float backVal;
-			if (scopeVca) {
-				int8_t polySelect = channel->channelSettings2.cc4[0];
-				
-				// VcaPost
-				int postSize = channel->getVcaPostSize();
-				if (polySelect < 16 && postSize > polySelect) {
-					frontVal = channel->getVcaPost(polySelect);
-				}
-				else if (polySelect == 16 && postSize > 0) {
-					frontVal = channel->getVcaPost(0);
-					if (postSize > 1) {
-						frontVal = (frontVal + channel->getVcaPost(1)) * 0.5f;
-					}
+			getScopeValues(channel, scopeVca, &frontVal, &backVal);
+			if (cap->bin != bin) {
+				if (cap->bin != -1) {
+					pushBin(c, resIndex);
 				}
-				else {
-					frontVal = 0.0f;
-				}
-				
-				// VcaPre
-				int preSize = channel->getVcaPreSize();
-				if (polySelect < 16 && preSize > polySelect) {
-					backVal = channel->getVcaPre(polySelect);
+				// new bin, so set min and max to new val
+				cap->bin = bin;
+				cap->acc.frontMin = cap->acc.frontMax = frontVal;
+				cap->acc.backMin = cap->acc.backMax = backVal;
+				cap->frontSumSq = frontVal * frontVal;
+				cap->backSumSq = backVal * backVal;
+				cap->count = 1;
+			}
+			else {
+				// same bin, write val to min or max
+				if (frontVal > cap->acc.frontMax) {
+					cap->acc.frontMax = frontVal;
 				}
-				else if (polySelect == 16 && preSize > 0) {
-					backVal = channel->getVcaPre(0);
-					if (preSize > 1) {
-						backVal = (backVal + channel->getVcaPre(1)) * 0.5f;
-					}
+				else if (frontVal < cap->acc.frontMin) {
+					cap->acc.frontMin = frontVal;
+				}	
+				if (backVal > cap->acc.backMax) {
+					cap->acc.backMax = backVal;
 				}
-				else {
-					backVal = 0.0f;
+				else if (backVal < cap->acc.backMin) {
+					cap->acc.backMin = backVal;
+				}	
+				cap->frontSumSq += frontVal * frontVal;
+				cap->backSumSq += backVal * backVal;
+				cap->count++;
+				if (cap->count % PARTIAL_PUSH_SAMPLES == 0) {
+					pushBin(c, resIndex);
 				}
 			}
-			else {
-				frontVal = channel->getScEnvelope();
-				backVal = channel->getScSignal();			
+		}
+	}
+	else {
+		traceOn[c] = false;
+	}
+}
+
+
+void ScopeEngine::pushBin(int c, int8_t resIndex) {
+	// when the ring is full (UI not drawing, or very short shapes with all channels captured), the bin is dropped
+	if (ring == nullptr || ring->full()) {
+		return;
+	}
+	Capture* cap = &captures[c];
+	Record rec;
+	rec.chan = c;
+	rec.resIndex = resIndex;
+	rec.bin = cap->bin;
+	rec.data = cap->acc;
+	float invCount = 1.0f / (float)cap->count;
+	rec.data.frontRms = std::sqrt(cap->frontSumSq * invCount);
+	rec.data.backRms = std::sqrt(cap->backSumSq * invCount);
+	ring->push(rec);
+}
+
+
+void ScopeEngine::drain(float sampleRate) {
+	RecordRing* r = audioRing.load(std::memory_order_acquire);
+	if (r != nullptr) {
+		while (!r->empty()) {
+			Record rec = r->shift();
+			if (rec.resIndex != viewResIndex) {
+				viewResIndex = rec.resIndex;
+				clear();
 			}
-			if (lastScpI != scpI) {
-				lastScpI = scpI;
-				// new point, so set min and max to new val
-				scpFrontYmin[scpI] = scpFrontYmax[scpI] = frontVal;
-				scpBackYmin[scpI] = scpBackYmax[scpI] = backVal;
+			if (rec.bin < 0) {
+				clearTrace(rec.chan);
 			}
 			else {
-				// same point, write val to min or max
-				if (frontVal > scpFrontYmax[scpI]) {
-					scpFrontYmax[scpI] = frontVal;
+				Trace* trace = &traces[rec.chan];
+				if (trace->bins.size() != (size_t)(getNumPts() + 1)) {
+					allocTrace(rec.chan);
 				}
-				else if (frontVal < scpFrontYmin[scpI]) {
-					scpFrontYmin[scpI] = frontVal;
-				}	
-				if (backVal > scpBackYmax[scpI]) {
-					scpBackYmax[scpI] = backVal;
-				}
-				else if (backVal < scpBackYmin[scpI]) {
-					scpBackYmin[scpI] = backVal;
-				}	
+				trace->bins[rec.bin] = rec.data;
+				trace->drawPoint[rec.bin >> 6] |= ((uint64_t)0x1 << (rec.bin & 0x3F));
 			}
 		}
 	}
-	else {
-		scopeOn = false;
+	
+	// free the traces of the channels that are no longer captured
+	for (int c = 0; c < 8; c++) {
+		if (!captured[c] && !traces[c].bins.empty()) {
+			std::vector<Bin>().swap(traces[c].bins);
+			std::vector<uint64_t>().swap(traces[c].drawPoint);
+		}
+	}
+	
+	updateRing(sampleRate);
+}
+
+
+void ScopeEngine::allocTrace(int c) {
+	// sized for the current resolution, the previous content (if any) is for another resolution and is dropped
+	int numPts = getNumPts();
+	traces[c].bins.resize(numPts + 1);
+	traces[c].drawPoint.assign((numPts + 1 + 63) / 64, 0);
+}
+
+
+void ScopeEngine::updateRing(float sampleRate) {
+	// a captured channel pushes at most about one record per sample, so the ring holds one (slow) frame of records
+	//   for each captured channel; it is replaced here and freed once the audio thread has picked up the new one
+	if (retiredRing != nullptr) {
+		if (audioRing.load(std::memory_order_acquire) == retiredRing) {
+			return;// still in use, or the engine is not running
+		}
+		delete retiredRing;
+		retiredRing = nullptr;
+	}
+	int numCaptured = 0;
+	for (int c = 0; c < 8; c++) {
+		if (captured[c]) {
+			numCaptured++;
+		}
+	}
+	size_t newSize = numCaptured == 0 ? 0 : (size_t)std::ceil(sampleRate * RING_FRAME_TIME) * numCaptured + 16;// + 16 for the clear records
+	RecordRing* oldRing = uiRing.load(std::memory_order_relaxed);
+	if ((oldRing == nullptr ? 0 : oldRing->capacity()) == newSize) {
+		return;
 	}
+	uiRing.store(newSize == 0 ? nullptr : new RecordRing(newSize), std::memory_order_release);
+	retiredRing = oldRing;
 }
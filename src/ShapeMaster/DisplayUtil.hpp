@@ -12,51 +12,159 @@
 #include "Channel.hpp"
 
 
-enum ScopeMasks {SCOPE_MASK_ON = 0x2, SCOPE_MASK_VCA_nSC = 0x1};
+enum ScopeMasks {SCOPE_MASK_ON = 0x2, SCOPE_MASK_VCA_nSC = 0x1, SCOPE_MASK_OVERLAY = 0x4};
 
-struct ScopeBuffers {
-	static const int SCOPE_PTS = 767;// scope memories, divide into this many segments, other code must be adapted if chaged (drawPoint binary stuff depends on this)
-	
-	// no need to reset/init the points during run, we will use the drawPoint flags for that
-	float scpFrontYmin[SCOPE_PTS + 1];// points of the main (front) scope curve, with an extra element for last
-	float scpFrontYmax[SCOPE_PTS + 1];// points of the main (front) scope curve, with an extra element for last
-	float scpBackYmin[SCOPE_PTS + 1];// points of the alt (back) scope curve, with an extra element for last
-	float scpBackYmax[SCOPE_PTS + 1];// points of the alt (back) scope curve, with an extra element for last
-	bool scopeOn;// takes channelActive into account (not the case in ScopeSettingsButtons())
+// Scope capture with min, max and RMS per segment (bin) of the traces, for the current channel or for all channels (overlay)
+// - audio thread: capture() accumulates the current bin of each captured channel, and pushes it into a lock-free ring
+//     when the play head moves to another bin (and periodically while it stays in the same bin)
+// - UI thread: drain() applies the pushed bins to the traces that are drawn, so that a bin is never seen partly written
+// Channels that are not displayed are not captured, so the per sample cost is the same as before when not in overlay mode
+// The ring and the traces are allocated by the UI thread for the captured channels only (nothing when the scope is off
+//   or when there is no UI), the ring holds one frame worth of records at the current sample rate
+struct ScopeEngine {
+	static const int PARTIAL_PUSH_SAMPLES = 256;// a bin that lasts longer than this is also pushed while it is being accumulated
+	static constexpr float RING_FRAME_TIME = 1.0f / 30.0f;// slowest UI frame rate that the ring can hold all the records for
+	
+	struct Bin {
+		float frontMin;
+		float frontMax;
+		float frontRms;
+		float backMin;
+		float backMax;
+		float backRms;
+	};
+	
+	struct Record {
+		int8_t chan;
+		int8_t resIndex;
+		int16_t bin;// -1 clears the channel's trace
+		Bin data;
+	};
+	
+	// single producer (audio), single consumer (UI), with a size set at run time (one element is kept empty)
+	struct RecordRing {
+		std::vector<Record> buf;
+		std::atomic<size_t> start;
+		std::atomic<size_t> end;
+		
+		RecordRing(size_t size) : buf(size + 1), start(0), end(0) {}
+		size_t next(size_t i) const {
+			return i + 1 >= buf.size() ? 0 : i + 1;
+		}
+		bool full() const {
+			return next(end.load(std::memory_order_relaxed)) == start.load(std::memory_order_acquire);
+		}
+		bool empty() const {
+			return start.load(std::memory_order_relaxed) == end.load(std::memory_order_acquire);
+		}
+		size_t capacity() const {
+			return buf.size() - 1;
+		}
+		void push(const Record& rec) {
+			size_t e = end.load(std::memory_order_relaxed);
+			buf[e] = rec;
+			end.store(next(e), std::memory_order_release);
+		}
+		Record shift() {
+			size_t s = start.load(std::memory_order_relaxed);
+			Record rec = buf[s];
+			start.store(next(s), std::memory_order_release);
+			return rec;
+		}
+	};
+	
+	
+	// audio thread
+	
+	struct Capture {
+		bool active;// captured in the previous sample
+		bool needClear;// a clear record must be pushed (retried when the ring is full)
+		int lastState;
+		int8_t lastTrigMode;
+		int bin;// bin being accumulated, -1 when none
+		Bin acc;
+		float frontSumSq;
+		float backSumSq;
+		int count;
+	};
+	Capture captures[8];
+	int8_t lastResIndex;
+	RecordRing* ring = nullptr;// ring being pushed into, nullptr until the UI has allocated one
+	
+	
+	// shared
+	
+	std::atomic<RecordRing*> uiRing;// ring allocated by the UI, picked up by the audio thread in capture()
+	std::atomic<RecordRing*> audioRing;// ring that the audio thread is pushing into, for drain() and to know when a retired ring can be freed
+	bool captured[8];// flags written by the audio thread, channels that need a trace
+	bool traceOn[8];// takes channelActive into account (not the case in ScopeSettingsButtons())
 	bool scopeVca;
-	int lastState;
-	int8_t lastTrigMode;
-	Channel* lastChannel;
 	
-	int lastScpI;
-	uint64_t drawPoint[12];// 12 is (767 + 1) / 64
 	
+	// UI thread
+	
+	struct Trace {
+		std::vector<Bin> bins;// with an extra element for last, empty when the channel is not captured
+		std::vector<uint64_t> drawPoint;// no need to reset/init the bins, we use the drawPoint flags for that
+	};
+	Trace traces[8];
+	int8_t viewResIndex;
+	RecordRing* retiredRing = nullptr;// replaced ring, freed once the audio thread has moved to the new one
+	
+	
+	ScopeEngine() : uiRing(nullptr), audioRing(nullptr) {}
+	~ScopeEngine() {
+		delete uiRing.load();
+		delete retiredRing;
+	}
 	
 	void reset() {
-		memset(scpFrontYmin, 0, sizeof(scpFrontYmin));
-		memset(scpFrontYmax, 0, sizeof(scpFrontYmax));
-		memset(scpBackYmin, 0, sizeof(scpBackYmin));
-		memset(scpBackYmax, 0, sizeof(scpBackYmax));
-		scopeOn = false;
+		for (int c = 0; c < 8; c++) {
+			captures[c].active = false;
+			captures[c].needClear = false;
+			captures[c].lastState = PlayHead::STOPPED;
+			captures[c].lastTrigMode = -1;
+			captures[c].bin = -1;
+			captured[c] = false;
+			traceOn[c] = false;
+		}
+		lastResIndex = 1;
+		viewResIndex = 1;
 		scopeVca = false;
-		lastState = PlayHead::STOPPED;
-		lastTrigMode = -1;
-		lastChannel = NULL;
 		clear();
 	}
 	void clear() {
-		lastScpI = -1;
-		memset(drawPoint, 0, sizeof(drawPoint));
+		for (int c = 0; c < 8; c++) {
+			clearTrace(c);
+		}
+	}
+	void clearTrace(int c) {
+		std::fill(traces[c].drawPoint.begin(), traces[c].drawPoint.end(), 0);
 	}
 	
-	void setPoint(uint64_t i) {
-		drawPoint[i >> 6] |= ((uint64_t)0x1 << (i & (uint64_t)0x3F));
+	int getNumPts() {
+		return scopeResPts[viewResIndex];
 	}
-	bool isDrawPoint(uint64_t i) {
-		return ( drawPoint[i >> 6] & ((uint64_t)0x1 << (i & (uint64_t)0x3F)) ) != 0;
+	bool isDrawPoint(int c, int i) {
+		if ((size_t)i >= traces[c].bins.size()) {
+			return false;// trace not allocated yet, or still sized for the previous resolution
+		}
+		return ( traces[c].drawPoint[i >> 6] & ((uint64_t)0x1 << (i & 0x3F)) ) != 0;
 	}
+	const Bin* getBins(int c) {
+		return traces[c].bins.data();
+	}
+	
+	void capture(Channel* channels, int currChan, int8_t scopeSettings, int8_t resIndex);
+	
+	void drain(float sampleRate);
+	
+	private:
 	
-	void populate(Channel* channel, int8_t scopeSettings);
+	void captureChannel(int c, Channel* channel, int8_t scopeSettings, int8_t resIndex);
+	void pushBin(int c, int8_t resIndex);
+	void allocTrace(int c);
+	void updateRing(float sampleRate);
 };
 
 
@@ -103,19 +103,109 @@ void ChannelChange::redo() {
 // Shape
 // ----------------------------------------------------------------------------
 
+int ShapeNodePool::calcClass(int count) {
+	int cl = 0;
+	for (int capacity = MIN_CAPACITY; capacity < count && cl < (NUM_CLASSES - 1); capacity <<= 1) {
+		cl++;
+	}
+	return cl;
+}
+
+ShapeNodePool::~ShapeNodePool() {
+	for (int cl = 0; cl < NUM_CLASSES; cl++) {
+		for (ShapeNode* block : freeBlocks[cl]) {
+			delete[] block;
+		}
+	}
+}
+
+ShapeNodePool* ShapeNodePool::get() {
+	static ShapeNodePool pool;
+	return &pool;
+}
+
+ShapeNode* ShapeNodePool::alloc(int count) {
+	if (count <= 0) {
+		return nullptr;
+	}
+	int cl = calcClass(count);
+	{
+		std::lock_guard<std::mutex> lk(poolMutex);
+		if (!freeBlocks[cl].empty()) {
+			ShapeNode* block = freeBlocks[cl].back();
+			freeBlocks[cl].pop_back();
+			return block;
+		}
+	}
+	return new ShapeNode[MIN_CAPACITY << cl];
+}
+
+void ShapeNodePool::release(ShapeNode* block, int count) {
+	if (block == nullptr) {
+		return;
+	}
+	std::lock_guard<std::mutex> lk(poolMutex);
+	freeBlocks[calcClass(count)].push_back(block);
+}
+
+
+void ShapeCompleteChange::captureOld() {
+	numOld = shapeSrc->getNumPts();
+	oldNodes = ShapeNodePool::get()->alloc(numOld);
+	shapeSrc->getNodes(oldNodes, 0, numOld);
+	oldHash = shapeSrc->calcNodesHash();
+}
+void ShapeCompleteChange::captureNew() {
+	// reduce the old snapshot to the changed range: skip the common leading and trailing nodes
+	//   (trailing nodes are matched from the end, so that inserted or removed nodes only cost the range they shift)
+	int numTotal = shapeSrc->getNumPts();
+	int maxCommon = std::min(numOld, numTotal);
+	int numLead = 0;
+	while (numLead < maxCommon && oldNodes[numLead] == shapeSrc->getNode(numLead)) {
+		numLead++;
+	}
+	int numTrail = 0;
+	while (numTrail < (maxCommon - numLead) && oldNodes[numOld - 1 - numTrail] == shapeSrc->getNode(numTotal - 1 - numTrail)) {
+		numTrail++;
+	}
+	
+	start = numLead;
+	int numChangedOld = numOld - numLead - numTrail;
+	ShapeNode* changedOld = ShapeNodePool::get()->alloc(numChangedOld);
+	for (int i = 0; i < numChangedOld; i++) {
+		changedOld[i] = oldNodes[start + i];
+	}
+	ShapeNodePool::get()->release(oldNodes, numOld);
+	oldNodes = changedOld;
+	numOld = numChangedOld;
+	
+	numNew = numTotal - numLead - numTrail;
+	numAllNew = numTotal;
+	newNodes = ShapeNodePool::get()->alloc(numAllNew);
+	shapeSrc->getNodes(newNodes, 0, numAllNew);
+	newHash = shapeSrc->calcNodesHash();
+}
 void ShapeCompleteChange::undo() {
-	shapeSrc->pasteShapeFrom(oldShape);
+	// the ranges no longer apply when the shape was changed without history since the change (CV reverse, invert, 
+	//   random, file loads by CV, etc.), the whole old shape is then rebuilt from the new one and restored
+	if (!shapeSrc->replaceNodes(start, numNew, oldNodes, numOld, newHash)) {
+		int numAllOld = numAllNew - numNew + numOld;
+		ShapeNode* allOldNodes = ShapeNodePool::get()->alloc(numAllOld);
+		std::copy(newNodes, newNodes + start, allOldNodes);
+		std::copy(oldNodes, oldNodes + numOld, allOldNodes + start);
+		std::copy(newNodes + start + numNew, newNodes + numAllNew, allOldNodes + start + numOld);
+		shapeSrc->setNodes(allOldNodes, numAllOld);
+		ShapeNodePool::get()->release(allOldNodes, numAllOld);
+	}
 }
 void ShapeCompleteChange::redo() {
-	shapeSrc->pasteShapeFrom(newShape);
+	if (!shapeSrc->replaceNodes(start, numOld, newNodes + start, numNew, oldHash)) {
+		shapeSrc->setNodes(newNodes, numAllNew);
+	}
 }
 ShapeCompleteChange::~ShapeCompleteChange() {
-	if (oldShape != NULL) {
-		delete oldShape;
-	}
-	if (newShape != NULL) {
-		delete newShape;
-	}
+	ShapeNodePool::get()->release(oldNodes, numOld);
+	ShapeNodePool::get()->release(newNodes, numAllNew);
 }
 
 
@@ -154,18 +154,51 @@ struct ChannelChange : ModuleAction {
 // ----------------------------------------------------------------------------
 
 class Shape;
+struct ShapeNode;
+
+
+// Pool of ShapeNode arrays for the shape history, so that long editing sessions reuse the same blocks instead of 
+//   fragmenting the heap; capacities are powers of two from MIN_CAPACITY up to the one that holds MAX_PTS nodes
+class ShapeNodePool {
+	static const int MIN_CAPACITY = 8;
+	static const int NUM_CLASSES = 7;// 8 to 512
+	
+	std::mutex poolMutex;
+	std::vector<ShapeNode*> freeBlocks[NUM_CLASSES];
+	
+	static int calcClass(int count);
+	
+	public:
+	
+	~ShapeNodePool();
+
+	static ShapeNodePool* get();
+	
+	ShapeNode* alloc(int count);// returns nullptr when count is 0
+	
+	void release(ShapeNode* block, int count);// count must be the one given to alloc()
+};
 
 
 struct ShapeCompleteChange : ModuleAction {
+	// the whole new shape is kept, but only the range of points that differs from it in the old shape:
+	//   undo replaces the numNew points at start with the oldNodes, redo does the opposite,
+	//   and when the shape was changed without history since then, the whole shape is restored instead
 	Shape* shapeSrc = nullptr;
-	Shape* oldShape = nullptr;
-	Shape* newShape = nullptr;
+	int start = 0;
+	int numOld = 0;// size of oldNodes (the whole old shape until captureNew() has been called)
+	int numNew = 0;// size of the changed range in newNodes
+	int numAllNew = 0;// size of newNodes
+	ShapeNode* oldNodes = nullptr;
+	ShapeNode* newNodes = nullptr;// whole new shape
+	uint64_t oldHash = 0;// of the whole shape, so that undo and redo only apply to the shape they were recorded on
+	uint64_t newHash = 0;
+	void captureOld();// call before the change, shapeSrc must be set
+	void captureNew();// call after the change
 	void undo() override;
 	void redo() override;
 	ShapeCompleteChange() {
 		name = "change shape";// provisional
-		oldShape = nullptr;
-		newShape = nullptr;
 	}
 	~ShapeCompleteChange();
 };
@@ -496,7 +496,7 @@ struct PasteChanelItem : MenuItem {
 		// Push ChannelChange history action (rest is done below)
 		ChannelChange* h = new ChannelChange;
 		h->channelSrc = channelDestination;
-		h->oldJson = channelDestination->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS);
+		h->oldJson = channelDestination->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS, WITH_BIN_SHAPE);
 		
 
 		bool successPaste = false;
@@ -525,7 +525,7 @@ struct PasteChanelItem : MenuItem {
 		}
 
 		if (successPaste) {
-			h->newJson = channelDestination->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS);
+			h->newJson = channelDestination->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS, WITH_BIN_SHAPE);
 			h->name = "paste channel";
 			APP->history->push(h);
 		}
@@ -542,11 +542,11 @@ struct InitializeChanelItem : MenuItem {
 		// Push ChannelChange history action (rest is done in onDragEnd())
 		ChannelChange* h = new ChannelChange;
 		h->channelSrc = channel;
-		h->oldJson = channel->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS);
+		h->oldJson = channel->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS, WITH_BIN_SHAPE);
 
 		channel->onReset(true);
 		
-		h->newJson = channel->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS);
+		h->newJson = channel->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS, WITH_BIN_SHAPE);
 		h->name = "initialize channel";
 		APP->history->push(h);
 	}
@@ -766,6 +766,19 @@ void createChannelMenu(ui::Menu* menu, Channel* channels, int chan, const Packed
 		[=]() {channels[chan].toggleForced0VWhenStopped();}
 	));	
 
+	menu->addChild(createSubmenuItem("CV output rate", "", [=](Menu* menu) {
+		menu->addChild(createCheckMenuItem("Audio rate (default)", "",
+			[=]() {return channels[chan].getCtrlRateIndex() == 0;},
+			[=]() {channels[chan].setCtrlRateIndex(0);}
+		));
+		for (int i = 1; i < NUM_CTRL_RATES; i++) {
+			menu->addChild(createCheckMenuItem(string::f("Control rate (1/%i)", ctrlRateDivs[i]), "",
+				[=]() {return channels[chan].getCtrlRateIndex() == i;},
+				[=]() {channels[chan].setCtrlRateIndex(i);}
+			));
+		}
+	}));
+
 	menu->addChild(createCheckMenuItem("Use sustain as channel reset", "",
 		[=]() {return channels[chan].isChannelResetOnSustain();},
 		[=]() {channels[chan].toggleChannelResetOnSustain();}
@@ -1099,6 +1112,34 @@ void createSidechainSettingsMenu(Channel* channel) {
 	SensitivitySlider *sensitivitySlider = new SensitivitySlider(channel);
 	sensitivitySlider->box.size.x = 200.0f;
 	menu->addChild(sensitivitySlider);
+
+	menu->addChild(new MenuSeparator());
+
+	menu->addChild(createSubmenuItem("Detector", "", [=](Menu* menu) {
+		menu->addChild(createCheckMenuItem("Peak (default)", "",
+			[=]() {return channel->getScDetector() == SCD_PEAK;},
+			[=]() {channel->setScDetector(SCD_PEAK);}
+		));
+		for (int i = 0; i < NUM_SC_RMS_WINDOWS; i++) {
+			menu->addChild(createCheckMenuItem(string::f("RMS %i ms", (int)(scRmsWindows[i] * 1000.0f + 0.5f)), "",
+				[=]() {return channel->getScDetector() == SCD_RMS && channel->getScRmsWindowIndex() == i;},
+				[=]() {channel->setScRmsWindowIndex(i); channel->setScDetector(SCD_RMS);}
+			));
+		}
+	}));
+
+	menu->addChild(createSubmenuItem("Look-ahead", "", [=](Menu* menu) {
+		menu->addChild(createCheckMenuItem("Off (default)", "",
+			[=]() {return channel->getScLookAheadIndex() == 0;},
+			[=]() {channel->setScLookAheadIndex(0);}
+		));
+		for (int i = 1; i < NUM_SC_LOOKAHEADS; i++) {
+			menu->addChild(createCheckMenuItem(string::f("%i ms", (int)(scLookAheadTimes[i] * 1000.0f + 0.5f)), "",
+				[=]() {return channel->getScLookAheadIndex() == i;},
+				[=]() {channel->setScLookAheadIndex(i);}
+			));
+		}
+	}));
 }
 
 
@@ -202,7 +202,7 @@ bool PlayHead::dataFromJsonPlayHead(json_t *channelJ, bool withParams, bool isDi
 	if (playModeJ) playMode = json_integer_value(playModeJ);
 	
 	json_t *trigModeJ = json_object_get(channelJ, "triggerMode");
-	if (trigModeJ) trigMode = json_integer_value(trigModeJ);
+	if (trigModeJ) trigMode = clamp((int)json_integer_value(trigModeJ), 0, NUM_TRIG_MODES - 1);
 	
 	json_t *hysteresisJ = json_object_get(channelJ, "hysteresis");
 	if (hysteresisJ) hysteresis = json_number_value(hysteresisJ);
@@ -244,27 +244,25 @@ bool PlayHead::dataFromJsonPlayHead(json_t *channelJ, bool withParams, bool isDi
 }
 
 
-bool PlayHead::isDirty(PlayHead* refPlayHead) {
-	if (paSync->getValue() != refPlayHead->paSync->getValue()) return true;// float comparison ok since button
-	if (paLock->getValue() != refPlayHead->paLock->getValue()) return true;// float comparison ok since button
-	if (paRepetitions->getValue() != refPlayHead->paRepetitions->getValue()) return true;// int in float comparison
-	if (paLengthSync->getValue() != refPlayHead->paLengthSync->getValue()) return true;// int in float comparison
-	if (std::round(paLengthUnsync->getValue() * 1e4f) != std::round(refPlayHead->paLengthUnsync->getValue() * 1e4f)) return true;// float comparison to fourth decimal
-	if (playMode != refPlayHead->playMode) return true;// int comparison
-	if (trigMode != refPlayHead->trigMode) return true;// int comparison
-	if (std::round(paSwing->getValue() * 1e3f) != std::round(refPlayHead->paSwing->getValue() * 1e3f)) return true;// percent comparison
-	if (paOffset->getValue() != refPlayHead->paOffset->getValue()) return true;// int in float comparison
-	if (paAudition->getValue() != refPlayHead->paAudition->getValue()) return true;// float comparison ok since button
-	// if (paFreeze->getValue() != refPlayHead->paFreeze->getValue()) return true;// excluded from dirty comparison
-	// if (paPlay->getValue() != refPlayHead->paPlay->getValue()) return true;// excluded from dirty comparison
-	if (std::round(getTrigLevel() * 100.0f) != std::round(refPlayHead->getTrigLevel() * 100.0f)) return true;// centivolts
-	if (!(getHysteresisText() == refPlayHead->getHysteresisText())) return true;// text comparison (easier)
-	if (!(getHoldOffText() == refPlayHead->getHoldOffText())) return true;// text comparison (easier)
-	if (paSustainLoop->getValue() != refPlayHead->paSustainLoop->getValue()) return true;
-	if (std::round((float)loopEndAndSustain * 1e3f) != std::round((float)(refPlayHead->loopEndAndSustain) * 1e3f)) return true;// float comparison to third decimal
-	if (std::round(loopStart * 1e3f) != std::round(refPlayHead->loopStart * 1e3f)) return true;// float comparison to third decimal
-	if (playHeadSettings3.cc1 != refPlayHead->playHeadSettings3.cc1) return true;// int comparison
-	return false;
+void PlayHead::addToDirtyHash(DirtyHash* dh) {
+	dh->addRounded(paSync->getValue());// button
+	dh->addRounded(paLock->getValue());// button
+	dh->addRounded(paRepetitions->getValue());// int in float
+	dh->addRounded(paLengthSync->getValue());// int in float
+	dh->addRounded(paLengthUnsync->getValue() * 1e4f);// float to fourth decimal
+	dh->add((int64_t)playMode);
+	dh->add((int64_t)trigMode);
+	dh->addRounded(paSwing->getValue() * 1e3f);// percent
+	dh->addRounded(paOffset->getValue());// int in float
+	dh->addRounded(paAudition->getValue());// button
+	// paFreeze and paPlay excluded from dirty comparison
+	dh->addRounded(getTrigLevel() * 100.0f);// centivolts
+	dh->add(getHysteresisText());// text (easier)
+	dh->add(getHoldOffText());// text (easier)
+	dh->addRounded(paSustainLoop->getValue());// button
+	dh->addRounded((float)loopEndAndSustain * 1e3f);// float to third decimal
+	dh->addRounded(loopStart * 1e3f);// float to third decimal
+	dh->add((int64_t)playHeadSettings3.cc1);
 }
 
 
@@ -295,7 +293,7 @@ void PlayHead::processSlow(ChanCvs *chanCvs) {
 		if (isInvalidLoopVsTrigMode()) {
 			paSustainLoop->setValue(0.0f);
 		}	
-		if (trigMode == TM_CV) {
+		if (trigMode == TM_CV || trigMode == TM_OSC) {
 			localSyncButton = false;
 			localLockButton = false;
 			paSync->setValue(0.0f);
@@ -432,6 +430,19 @@ double PlayHead::process(ChanCvs *chanCvs) {
 		reverse = false;
 		return xt;
 	}
+	// OSC
+	else if (trigMode == TM_OSC) {
+		if ( *running && localPlayButton && !localFreezeButton ) {
+			float inV = clamp(inTrig->getVoltage(), -10.0f, 10.0f);
+			oscNormFreq = (float)(dsp::FREQ_C4 * fastExp2(inV) * clockDetector->getSampleTime());
+			xt += (double)oscNormFreq;
+			if (xt >= 1.0) {
+				xt -= std::floor(xt);
+			}
+		}
+		reverse = false;
+		return xt;
+	}
 	
 	// pending trig counter
 	if (pendingTrig >= 0) {
@@ -11,6 +11,8 @@
 #include "../MindMeldModular.hpp"
 #include "Util.hpp"
 #include "ClockDetector.hpp"
+#include "DirtyHash.hpp"
+#include "CurveKernel.hpp"
 
 class PresetAndShapeManager;
 
@@ -84,6 +86,7 @@ class PlayHead {
 	int32_t cycleCount = 0;// start at 0
 	int32_t lengthIndex = 0;// start at 0, can only be 0 or 1
 	double xt = 0.0;// in normalized time [0: 1[ (only moves forward for simplicity, code will adjust for backward cycles)
+	float oscNormFreq = 0.0f;// oscillator frequency / sample rate, only used in TM_OSC
 	long pendingTrig = 0;
 	dsp::PulseGenerator slowSlewPulseGen;// to force a slower slew when state change or reset, etc. The pulse's duration should be 1/RF (in seconds) where RF is the riseFall number if the dependant slew generator
 	int8_t lastTrigMode = 0;
@@ -332,6 +335,9 @@ class PlayHead {
 	int8_t getTrigMode() {
 		return trigMode;
 	}
+	float getOscNormFreq() {
+		return oscNormFreq;
+	}
 
 	float getLoopStart() {
 		return loopStart;
@@ -452,7 +458,7 @@ class PlayHead {
 	#endif
 
 	
-	bool isDirty(PlayHead* refPlayHead);
+	void addToDirtyHash(DirtyHash* dh);
 	
 	
 	void hold() {
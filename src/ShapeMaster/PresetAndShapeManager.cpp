@@ -44,8 +44,15 @@ bool loadPresetOrShape(const std::string& path, Channel* dest, bool isPreset, bo
 #endif
 		return false;
 	}
-	// else must json_decref(presetOrShapeFileJ) on all returns
 	
+	bool success = loadPresetOrShapeFromJson(presetOrShapeFileJ, path, dest, isPreset, unsupportedSync, withHistory);
+	json_decref(presetOrShapeFileJ);
+	return success;
+}
+
+
+bool loadPresetOrShapeFromJson(json_t* presetOrShapeFileJ, const std::string& path, Channel* dest, bool isPreset, bool* unsupportedSync, bool withHistory) {
+	// same as loadPresetOrShape() but with the file already parsed, presetOrShapeFileJ is not decref'd in here
 	json_t *channelPresetOrShapeJ = json_object_get(presetOrShapeFileJ, isPreset ? "ShapeMaster channel preset" : "ShapeMaster shape");
 	if (!channelPresetOrShapeJ) {
 		std::string message = isPreset ? "INVALID ShapeMaster channel preset file" : "INVALID ShapeMaster shape file";
@@ -54,7 +61,6 @@ bool loadPresetOrShape(const std::string& path, Channel* dest, bool isPreset, bo
 #else
 		osdialog_message(OSDIALOG_WARNING, OSDIALOG_OK, message.c_str());
 #endif
-		json_decref(presetOrShapeFileJ);
 		return false;
 	}
 
@@ -68,7 +74,7 @@ bool loadPresetOrShape(const std::string& path, Channel* dest, bool isPreset, bo
 
 	if (isPreset) {
 		if (h) {
-			h->oldJson = dest->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS);
+			h->oldJson = dest->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS, WITH_BIN_SHAPE);
 		}
 		
 		bool isDirtyCacheLoad = unsupportedSync != NULL;
@@ -79,13 +85,13 @@ bool loadPresetOrShape(const std::string& path, Channel* dest, bool isPreset, bo
 		dest->setPresetPath(path);
 		
 		if (h) {
-			h->newJson = dest->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS);
+			h->newJson = dest->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS, WITH_BIN_SHAPE);
 			h->name = "load preset";
 		}
 	}
 	else {// shape
 		if (h) {
-			h->oldJson = dest->getShape()->dataToJsonShape();
+			h->oldJson = dest->getShape()->dataToJsonShape(WITH_BIN_SHAPE);
 			h->oldShapePath = dest->getShapePath();
 		}
 		
@@ -93,7 +99,7 @@ bool loadPresetOrShape(const std::string& path, Channel* dest, bool isPreset, bo
 		dest->setShapePath(path);
 		
 		if (h) {
-			h->newJson = dest->getShape()->dataToJsonShape();
+			h->newJson = dest->getShape()->dataToJsonShape(WITH_BIN_SHAPE);
 			h->newShapePath = dest->getShapePath();
 			h->name = "load shape";
 		}
@@ -101,13 +107,29 @@ bool loadPresetOrShape(const std::string& path, Channel* dest, bool isPreset, bo
 	if (h) {
 		APP->history->push(h);
 	}
-	json_decref(presetOrShapeFileJ);
 	return true;
 }
 
 
-void savePresetOrShape(const std::string& path, Channel* channel, bool isPreset, Channel* channelDirtyCache) {
+void savePresetOrShape(const std::string& path, Channel* channel, bool isPreset, PresetAndShapeManager* presetAndShapeManager) {
 	INFO((isPreset ? "Saving ShapeMaster channel preset %s" : "Saving ShapeMaster shape %s"), path.c_str());
+	if (!writePresetOrShapeFile(path, channel, isPreset)) {
+		// Fail silently
+		return;
+	}
+
+	if (isPreset) {
+		channel->setPresetPath(path);
+	}
+	else {
+		channel->setShapePath(path);
+	}
+	presetAndShapeManager->invalidateDirtyRef();// force reload for dirty comparison (or else star will stay since not reloaded as path not changed)
+}
+
+
+bool writePresetOrShapeFile(const std::string& path, Channel* channel, bool isPreset) {
+	// returns success, does not change the channel's preset or shape path (also used by the preset batch)
 	json_t* channelPresetOrShapeJ = isPreset ? 
 		channel->dataToJsonChannel(WITH_PARAMS, WITH_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS) : 
 		channel->dataToJsonShape();
@@ -118,23 +140,15 @@ void savePresetOrShape(const std::string& path, Channel* channel, bool isPreset,
 	std::string tmpPath = path + ".tmp";
 	FILE* file = std::fopen(tmpPath.c_str(), "w");
 	if (!file) {
-		// Fail silently
-		return;
+		json_decref(presetOrShapeFileJ);
+		return false;
 	}
 
 	json_dumpf(presetOrShapeFileJ, file, JSON_INDENT(2) | JSON_REAL_PRECISION(9));
 	std::fclose(file);
 	json_decref(presetOrShapeFileJ);
 	system::copy(tmpPath, path); system::remove(tmpPath);// system::moveFile(tmpPath, path);
-
-	if (isPreset) {
-		channel->setPresetPath(path);
-		channelDirtyCache->setPresetPath("");// force reload for dirty comparison (or else star will stay since not reloaded as path not changed)
-	}
-	else {
-		channel->setShapePath(path);
-		channelDirtyCache->setShapePath("");// force reload for dirty comparison (or else star will stay since not reloaded as path not changed)
-	}
+	return true;
 }
 
 
@@ -168,124 +182,210 @@ void PresetAndShapeManager::construct(Channel* _channels, Channel* _channelDirty
 
 
 void PresetAndShapeManager::executeOrStageWorkload(int c, int _workType, bool _withHistory, bool stage) {
+	// audio thread, the request is coalesced into the channel's pending work (no file access or waiting on the workers)
+	ChannelWork* cw = &channelWork[c];
 	if (_workType <= WT_NEXT_SHAPE) {
 		// file operation
-		if ( stage && (miscSettings3->cc4[_workType <= WT_NEXT_PRESET ? 0 : 1] != 0) ) {
-			if (requestWork[c] != WS_TODO) {
-				workType[c] = _workType;
-				withHistory[c] = _withHistory;
-				requestWork[c] = WS_STAGED;
+		bool isPreset = _workType <= WT_NEXT_PRESET;
+		int step = (_workType == WT_PREV_PRESET || _workType == WT_PREV_SHAPE) ? -1 : 1;
+		if ( stage && (miscSettings3->cc4[isPreset ? 0 : 1] != 0) ) {
+			if (_withHistory) {
+				cw->stagedWithHistory.store(true);
 			}
+			ChannelWork::addSteps(isPreset ? &cw->stagedPresetSteps : &cw->stagedShapeSteps, step);
 		}
 		else {
-			if (requestWork[c] == WS_NONE) {
-				workType[c] = _workType;
-				withHistory[c] = _withHistory;
-				requestWork[c] = WS_TODO;
-				cv.notify_one();
+			if (_withHistory) {
+				cw->withHistory.store(true);
 			}
+			cw->addFileSteps(isPreset, step);
+			signal.notify();
 		}
 	}
 	else {
 		// other operation (reverse, inverse, random); _withHistory and stage are ignored (assumed false)
-		if (requestWork[c] == WS_NONE) {
-			workType[c] = _workType;
-			withHistory[c] = false;
-			requestWork[c] = WS_TODO;
-			cv.notify_one();
+		if (_workType == WT_REVERSE) {
+			cw->reverseParity.fetch_xor(1);
+		}
+		else if (_workType == WT_INVERT) {
+			cw->invertParity.fetch_xor(1);
+		}
+		else {
+			cw->randomize.store(true);
 		}
+		signal.notify();
 	}
 }
 
 
-PresetAndShapeManager::PresetAndShapeManager() : worker(&PresetAndShapeManager::file_worker, this) {
+PresetAndShapeManager::PresetAndShapeManager() : dirtyRefState(DRS_NONE), dirtyRefInvalid(false), dirtyRefBusy(false), batchRunning(false), batchCancel(false), batchDone(false) {
 	context = contextGet();
+	// workers are started last, once all the members they use are constructed
+	for (int w = 0; w < NUM_WORKERS; w++) {
+		workers[w] = std::thread(&PresetAndShapeManager::file_worker, this);
+	}
+}
+
+
+int PresetAndShapeManager::getDirtyRef(const std::string& path, bool isPreset, uint64_t* hash, bool* unsupportedSync) {
+	// UI thread, returns the state of the reference for the given file, and requests it when needed
+	// hash and unsupportedSync are only written when the returned state is DRS_READY
+	int state = dirtyRefState.load();
+	if (state == DRS_LOADING) {
+		return DRS_LOADING;
+	}
+	if (state != DRS_NONE && !dirtyRefInvalid.load() && dirtyRefIsPreset == isPreset && dirtyRefPath == path) {
+		if (state == DRS_READY) {
+			*hash = dirtyRefHash;
+			if (isPreset) {
+				*unsupportedSync = dirtyRefUnsupportedSync;
+			}
+		}
+		else {
+			dirtyRefState.store(DRS_NONE);// DRS_FAILED is only reported once, so that the same file can be retried when it's loaded again
+		}
+		return state;
+	}
+	dirtyRefPath = path;
+	dirtyRefIsPreset = isPreset;
+	dirtyRefInvalid.store(false);
+	dirtyRefState.store(DRS_LOADING);
+	signal.notify();
+	return DRS_LOADING;
+}
+
+
+void PresetAndShapeManager::loadDirtyRef() {
+	// worker thread, dirtyRefState is DRS_LOADING so the UI doesn't touch the dirtyRef members
+	bool success = false;
+	json_t* presetOrShapeFileJ = library.getParsed(dirtyRefPath);
+	if (presetOrShapeFileJ) {
+		success = loadPresetOrShapeFromJson(presetOrShapeFileJ, dirtyRefPath, channelDirtyCacheSrc, dirtyRefIsPreset, dirtyRefIsPreset ? &dirtyRefUnsupportedSync : NULL, false);
+		json_decref(presetOrShapeFileJ);
+	}
+	if (success) {
+		dirtyRefHash = dirtyRefIsPreset ? channelDirtyCacheSrc->calcDirtyHash() : channelDirtyCacheSrc->calcDirtyHashShape();
+	}
+	dirtyRefState.store(success ? DRS_READY : DRS_FAILED);
+}
+
+
+void PresetAndShapeManager::loadNeighbour(Channel* channel, bool isPreset, int steps, bool withHistory, std::vector<std::string>* prefetchPaths) {
+	// worker thread, loads the preset or shape that is steps files away from the channel's current one
+	std::string path = isPreset ? channel->getPresetPath() : channel->getShapePath();
+	if (path.empty()) {
+		return;
+	}
+	bool getPrev = steps < 0;
+	int distance = std::abs(steps);
+	std::string assetPluginPath = asset::plugin(pluginInstance, "");
+	std::string newPath;
+	if (path.compare(0, assetPluginPath.size(), assetPluginPath) == 0) {
+		// factory
+		const std::vector<std::string>* factoryVector = isPreset ? &(factoryPresetVector) : &(factoryShapeVector);
+		int size = (int)factoryVector->size();
+		for (int i = 0; i < size; i++) {
+			if (path == (*factoryVector)[i]) {
+				int newIndex = ((i + steps) % size + size) % size;
+				newPath = (*factoryVector)[newIndex];
+				int prefetchIndex = newIndex + size + (getPrev ? -1 : 1);
+				prefetchPaths->push_back((*factoryVector)[prefetchIndex % size]);
+				break;
+			}
+		}
+	}
+	else {
+		// user
+		std::string presetOrShapeExt = (isPreset ? ".smpr" : ".smsh");
+		newPath = library.getNeighbour(path, presetOrShapeExt, getPrev, distance);
+		if (!newPath.empty()) {
+			prefetchPaths->push_back(library.getNeighbour(path, presetOrShapeExt, getPrev, distance + 1));
+		}
+	}
+	if (!newPath.empty()) {
+		json_t* presetOrShapeFileJ = library.getParsed(newPath);
+		if (presetOrShapeFileJ) {
+			loadPresetOrShapeFromJson(presetOrShapeFileJ, newPath, channel, isPreset, NULL, withHistory);
+			json_decref(presetOrShapeFileJ);
+		}
+		else {
+			loadPresetOrShape(newPath, channel, isPreset, NULL, withHistory);// will show the error message
+		}
+	}
+}
+
+
+void PresetAndShapeManager::serveChannel(int chan, std::vector<std::string>* prefetchPaths) {
+	// worker thread, the channel is claimed (busy); all its pending work is taken at once, 
+	//   and what the audio thread adds in the meantime is served in the next round
+	ChannelWork* cw = &channelWork[chan];
+	Channel* channel = &channels[chan];
+	bool withHistory = cw->withHistory.exchange(false);
+	int presetSteps = cw->presetSteps.exchange(0);
+	int shapeSteps = cw->shapeSteps.exchange(0);
+	if (presetSteps != 0) {
+		loadNeighbour(channel, true, presetSteps, withHistory, prefetchPaths);
+	}
+	if (shapeSteps != 0) {
+		loadNeighbour(channel, false, shapeSteps, withHistory, prefetchPaths);
+	}
+	if (cw->reverseParity.exchange(0) != 0) {
+		channel->reverseShape();
+	}
+	if (cw->invertParity.exchange(0) != 0) {
+		channel->invertShape();
+	}
+	if (cw->randomize.exchange(false)) {
+		channel->randomizeShape(false);
+	}
+	cw->busy.store(false);// completion, seen by the audio thread without any locking
 }
 
 
 void PresetAndShapeManager::file_worker() {
 	contextSet(context);
 	random::init();// Rack doc says to call once per thread, or else random::u32() etc will always return 0
-	while (true) {
-		std::unique_lock<std::mutex> lk(mtx);
-		while (!(requestWork[0] == WS_TODO || requestWork[1] == WS_TODO || 
-				requestWork[2] == WS_TODO || requestWork[3] == WS_TODO || 
-				requestWork[4] == WS_TODO || requestWork[5] == WS_TODO || 
-				requestWork[6] == WS_TODO || requestWork[7] == WS_TODO || requestStop)) {
-			cv.wait(lk);
-		}
-		lk.unlock();
-		if (requestStop) break;
+	std::vector<std::string> prefetchPaths;
+	while (signal.wait()) {
+		if (dirtyRefState.load() == DRS_LOADING) {
+			bool expected = false;
+			if (dirtyRefBusy.compare_exchange_strong(expected, true)) {
+				if (dirtyRefState.load() == DRS_LOADING) {
+					loadDirtyRef();
+				}
+				dirtyRefBusy.store(false);
+			}
+		}
 		
+		// each channel is served by one worker at a time, so that its operations stay in order
 		for (int chan = 0; chan < 8; chan++) {
-			if (requestWork[chan] == WS_TODO) {		
-				Channel* channel = &channels[chan];
-				if (workType[chan] <= WT_NEXT_SHAPE) {
-					// file operation
-					bool isPreset = workType[chan] <= WT_NEXT_PRESET;
-					bool getPrev = (workType[chan] == WT_PREV_PRESET || workType[chan] == WT_PREV_SHAPE);
-					std::string path = isPreset ? channel->getPresetPath() : channel->getShapePath();
-					if (!path.empty()) {
-						std::string assetPluginPath = asset::plugin(pluginInstance, "");
-						if (path.compare(0, assetPluginPath.size(), assetPluginPath) == 0) {
-							// factory
-							const std::vector<std::string>* factoryVector = isPreset ? &(factoryPresetVector) : &(factoryShapeVector);
-							for (size_t i = 0; i < factoryVector->size(); i++) {
-								if (path == (*factoryVector)[i]) {
-									int newIndex = i + factoryVector->size() + (getPrev ? -1 : 1);
-									newIndex %= factoryVector->size();
-									loadPresetOrShape((*factoryVector)[newIndex], channel, isPreset, NULL, withHistory[chan]);
-									break;
-								}
-							}
-						}
-						else {
-							// user
-							std::vector<std::string> userEntries = system::getEntries(system::getDirectory(path));// string::directory(path)
-							std::sort(userEntries.begin(), userEntries.end());
-							std::vector<std::string> userVector;
-							int pathIndex = -1;
-							std::string presetOrShapeExt = (isPreset ? ".smpr" : ".smsh");
-							for (std::string entry : userEntries) {
-								if (!(system::isFile(entry) && system::getExtension(entry) == presetOrShapeExt)) {
-									continue;
-								}
-								if (path == entry) {
-									pathIndex = userVector.size();
-								}					
-								userVector.push_back(entry);
-							}
-							if (pathIndex != -1) {
-								int newIndex = pathIndex + userVector.size() + (getPrev ? -1 : 1);
-								newIndex %= userVector.size();
-								loadPresetOrShape(userVector[newIndex], channel, isPreset, NULL, withHistory[chan]);
-							}
-						}
-					}
+			if (channelWork[chan].hasWork() && channelWork[chan].claim()) {
+				if (isAnyWorkTodo()) {
+					signal.notify();// let the other worker take the other channels meanwhile
 				}
-				else {
-					// other operation (reverse, inverse, random)
-					if (workType[chan] == WT_REVERSE) {
-						channel->reverseShape();
-					}
-					else if (workType[chan] == WT_INVERT) {
-						channel->invertShape();
-					}
-					else if (workType[chan] == WT_RANDOM) {
-						channel->randomizeShape(false);
-					}
-				}
-				requestWork[chan] = WS_NONE;
-			}//if TODO
-		}// for chan
-	}// while(true)
+				serveChannel(chan, &prefetchPaths);
+			}
+		}
+		if (isAnyWorkTodo()) {
+			signal.notify();// work that came in for a channel while it was being served (by this or the other worker)
+			prefetchPaths.clear();
+			continue;
+		}
+		
+		// prefetch the presets or shapes that the next presses would load, unless more work came in
+		while (!prefetchPaths.empty() && !isAnyWorkTodo() && !signal.isStopping()) {
+			library.prefetch(prefetchPaths.back());
+			prefetchPaths.pop_back();
+		}
+		prefetchPaths.clear();
+	}
 }// file_worker()
 
 
 
 struct SaveUserSubItem : MenuItem {
 	Channel* channel;
-	Channel* channelDirtyCache;
+	PresetAndShapeManager* presetAndShapeManager;
 	bool isPreset = false;
 	
 	void onAction(const event::Action &e) override {
@@ -316,22 +416,22 @@ struct SaveUserSubItem : MenuItem {
 
 #ifdef USING_CARDINAL_NOT_RACK
 		Channel* channel = this->channel;
-		Channel* channelDirtyCache = this->channelDirtyCache;
+		PresetAndShapeManager* presetAndShapeManager = this->presetAndShapeManager;
 		bool isPreset = this->isPreset;
-		async_dialog_filebrowser(true, filename.c_str(), dir.c_str(), text.c_str(), [channel, channelDirtyCache, isPreset](char* pathC) {
-			pathSelected(channel, channelDirtyCache, isPreset, pathC);
+		async_dialog_filebrowser(true, filename.c_str(), dir.c_str(), text.c_str(), [channel, presetAndShapeManager, isPreset](char* pathC) {
+			pathSelected(channel, presetAndShapeManager, isPreset, pathC);
 		});
 #else
 		osdialog_filters* filters = osdialog_filters_parse(isPreset ? PRESET_FILTER : SHAPE_FILTER);
 
 		char* pathC = osdialog_file(OSDIALOG_SAVE, dir.c_str(), filename.c_str(), filters);
-		pathSelected(channel, channelDirtyCache, isPreset, pathC);
+		pathSelected(channel, presetAndShapeManager, isPreset, pathC);
 		osdialog_filters_free(filters);
 #endif
 		free(pathC);
 	}
 
-	static void pathSelected(Channel* channel, Channel* channelDirtyCache, bool isPreset, char* pathC) {
+	static void pathSelected(Channel* channel, PresetAndShapeManager* presetAndShapeManager, bool isPreset, char* pathC) {
 		if (!pathC) {
 			// Fail silently
 			return;
@@ -344,7 +444,7 @@ struct SaveUserSubItem : MenuItem {
 			pathStr += isPreset ? ".smpr" : ".smsh";
 		}
 
-		savePresetOrShape(pathStr, channel, isPreset, channelDirtyCache);
+		savePresetOrShape(pathStr, channel, isPreset, presetAndShapeManager);
 	}
 };
 
@@ -367,9 +467,9 @@ struct SaveInitPresetOrShapeItem : MenuItem {
 	Channel* channel;
 	bool isPreset;
 	std::string initFilePath;
-	Channel* channelDirtyCacheSrc;
+	PresetAndShapeManager* presetAndShapeManager;
 	void onAction(const event::Action &e) override {
-		savePresetOrShape(initFilePath, channel, isPreset, channelDirtyCacheSrc);
+		savePresetOrShape(initFilePath, channel, isPreset, presetAndShapeManager);
 	}
 };
 
@@ -384,11 +484,11 @@ struct LoadInitPresetOrShapeItem : MenuItem {
 		h->isPreset = isPreset;
 		if (isPreset) {
 			h->channelSrc = channel;
-			h->oldJson = channel->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS);
+			h->oldJson = channel->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS, WITH_BIN_SHAPE);
 		}
 		else {
 			h->shapeSrc = channel->getShape();
-			h->oldJson = h->shapeSrc->dataToJsonShape();
+			h->oldJson = h->shapeSrc->dataToJsonShape(WITH_BIN_SHAPE);
 		}
 		
 		if (!loadPresetOrShape(initFilePath, channel, isPreset, NULL, false)) {// history is managed here not in loadPresetOrShape(), since if init file not found we will do resets in the next lines
@@ -401,11 +501,11 @@ struct LoadInitPresetOrShapeItem : MenuItem {
 		}
 		
 		if (isPreset) {
-			h->newJson = channel->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS);
+			h->newJson = channel->dataToJsonChannel(WITH_PARAMS, WITHOUT_PRO_UNSYNC_MATCH, WITHOUT_FULL_SETTINGS, WITH_BIN_SHAPE);
 			h->name = "initialize preset";
 		}
 		else {
-			h->newJson = h->shapeSrc->dataToJsonShape();
+			h->newJson = h->shapeSrc->dataToJsonShape(WITH_BIN_SHAPE);
 			h->name = "initialize shape";
 		}
 		APP->history->push(h);
@@ -413,6 +513,66 @@ struct LoadInitPresetOrShapeItem : MenuItem {
 };
 
 
+bool PresetAndShapeManager::startBatch(const std::string& dirPath, const PresetBatchOptions& options) {
+	// UI thread, returns false when a batch is already running; the result is shown by showBatchResultIfDone()
+	if (batchRunning.load()) {
+		return false;
+	}
+	if (batchThread.joinable()) {
+		batchThread.join();// previous batch, already completed
+	}
+	batchRunning.store(true);
+	batchThread = std::thread([this, dirPath, options]() {
+		contextSet(context);
+		PresetBatchResult result = runPresetBatch(dirPath, options, &batchCancel);
+		if (result.numWritten > 0) {
+			invalidateDirtyRef();
+		}
+		batchResultText = presetBatchResultText(result, options);
+		batchDone.store(true);
+		batchRunning.store(false);
+	});
+	return true;
+}
+
+
+void PresetAndShapeManager::showBatchResultIfDone() {
+	// UI thread
+	if (batchDone.exchange(false)) {
+		std::string message = "ShapeMaster batch: " + batchResultText;
+#ifdef USING_CARDINAL_NOT_RACK
+		async_dialog_message(message.c_str());
+#else
+		osdialog_message(OSDIALOG_INFO, OSDIALOG_OK, message.c_str());
+#endif
+	}
+}
+
+
+#ifndef USING_CARDINAL_NOT_RACK
+static void runPresetBatchWithDialogs(PresetBatchOptions options, PresetAndShapeManager* presetAndShapeManager) {
+	if (presetAndShapeManager->isBatchRunning()) {
+		osdialog_message(OSDIALOG_WARNING, OSDIALOG_OK, "A batch is already running, its result will be shown when it is done.");
+		return;
+	}
+	std::string dir = getUserPath(options.isPreset);
+	char* pathC = osdialog_file(OSDIALOG_OPEN_DIR, dir.c_str(), NULL, NULL);
+	if (!pathC) {
+		return;
+	}
+	std::string pathStr = pathC;
+	free(pathC);
+	if (options.write) {
+		std::string message = string::f("All %s files in %s and its subfolders will be overwritten. Continue?", options.isPreset ? "preset" : "shape", pathStr.c_str());
+		if (!osdialog_message(OSDIALOG_WARNING, OSDIALOG_OK_CANCEL, message.c_str())) {
+			return;
+		}
+	}
+	presetAndShapeManager->startBatch(pathStr, options);
+}
+#endif
+
+
 void PresetAndShapeManager::createPresetOrShapeMenu(Channel* channel, bool isPreset) {
 	ui::Menu *menu = createMenu();
 	std::string dir;
@@ -448,7 +608,7 @@ void PresetAndShapeManager::createPresetOrShapeMenu(Channel* channel, bool isPre
 	// Save user preset or shape
 	SaveUserSubItem *saveUserItem = createMenuItem<SaveUserSubItem>(isPreset ? "Save user preset" : "Save user shape", "");
 	saveUserItem->channel = channel;
-	saveUserItem->channelDirtyCache = channelDirtyCacheSrc;
+	saveUserItem->presetAndShapeManager = this;
 	saveUserItem->isPreset = isPreset;
 	menu->addChild(saveUserItem);
 	
@@ -463,7 +623,7 @@ void PresetAndShapeManager::createPresetOrShapeMenu(Channel* channel, bool isPre
 	saveInitPSItem->channel = channel;
 	saveInitPSItem->isPreset = isPreset;
 	saveInitPSItem->initFilePath = userPath + "/~init." + (isPreset ? "smpr" : "smsh");
-	saveInitPSItem->channelDirtyCacheSrc = channelDirtyCacheSrc;
+	saveInitPSItem->presetAndShapeManager = this;
 	menu->addChild(saveInitPSItem);
 	
 	LoadInitPresetOrShapeItem* loadInitPSItem = createMenuItem<LoadInitPresetOrShapeItem>(isPreset ? "Initialize preset" : "Initialize shape");
@@ -472,6 +632,41 @@ void PresetAndShapeManager::createPresetOrShapeMenu(Channel* channel, bool isPre
 	loadInitPSItem->initFilePath = userPath + "/~init." + (isPreset ? "smpr" : "smsh");
 	menu->addChild(loadInitPSItem);
 	
+	#ifndef USING_CARDINAL_NOT_RACK
+	menu->addChild(new MenuSeparator());
+	
+	PresetAndShapeManager* presetAndShapeManager = this;
+	menu->addChild(createSubmenuItem(isPreset ? "Batch process preset folder" : "Batch process shape folder", "", [=](Menu* menu) {
+		PresetBatchOptions options;
+		options.isPreset = isPreset;
+		menu->addChild(createMenuItem("Re-save...", "", [=]() {
+			runPresetBatchWithDialogs(options, presetAndShapeManager);
+		}));
+		if (isPreset) {
+			menu->addChild(createMenuItem("Re-save with sync off...", "", [=]() {
+				PresetBatchOptions optionsNoSync = options;
+				optionsNoSync.stripSync = true;
+				runPresetBatchWithDialogs(optionsNoSync, presetAndShapeManager);
+			}));
+			menu->addChild(createSubmenuItem("Re-save with range", "", [=](Menu* menu) {
+				for (int r = 0; r < NUM_RANGE_OPTIONS; r++) {
+					std::string rangeText = rangeValues[r] > 0 ? string::f("0-%iV...", rangeValues[r]) : string::f("+/-%iV...", -rangeValues[r]);
+					menu->addChild(createMenuItem(rangeText, "", [=]() {
+						PresetBatchOptions optionsRange = options;
+						optionsRange.rangeIndex = r;
+						runPresetBatchWithDialogs(optionsRange, presetAndShapeManager);
+					}));
+				}
+			}));
+		}
+		menu->addChild(createMenuItem("Parse only (benchmark)...", "", [=]() {
+			PresetBatchOptions optionsParse = options;
+			optionsParse.write = false;
+			runPresetBatchWithDialogs(optionsParse, presetAndShapeManager);
+		}));
+	}));
+	#endif
+	
 }
 
 
@@ -9,39 +9,125 @@
 #pragma once
 
 #include <thread>
-#include <condition_variable>
 #include "osdialog.h"
 #include "Channel.hpp"
+#include "WorkSignal.hpp"
+#include "PresetLibrary.hpp"
+#include "PresetBatch.hpp"
 
 
+class PresetAndShapeManager;
+
 bool loadPresetOrShape(const std::string& path, Channel* dest, bool isPreset, bool* unsupportedSync, bool withHistory);
-void savePresetOrShape(const std::string& path, Channel* dest, bool isPreset, Channel* channelDirtyCache);
+bool loadPresetOrShapeFromJson(json_t* presetOrShapeFileJ, const std::string& path, Channel* dest, bool isPreset, bool* unsupportedSync, bool withHistory);
+void savePresetOrShape(const std::string& path, Channel* dest, bool isPreset, PresetAndShapeManager* presetAndShapeManager);
+bool writePresetOrShapeFile(const std::string& path, Channel* channel, bool isPreset);
 
 
 // ----------------------------------------------------------------------------
 // Preset and Shape Manager
 // ----------------------------------------------------------------------------
 
-enum WorkerState {WS_NONE, WS_STAGED, WS_TODO};// staged is not managed in here, it is a mem for sync locked scheduled shape change only
 enum WorkType {WT_PREV_PRESET, WT_NEXT_PRESET, WT_PREV_SHAPE, WT_NEXT_SHAPE, WT_REVERSE, WT_INVERT, WT_RANDOM};
+enum DirtyRefState {DRS_NONE, DRS_LOADING, DRS_READY, DRS_FAILED};
+
+
+// Pending work of a channel, coalesced so that no request is lost while the pending work of a channel stays bounded:
+//   prev/next requests add up into a number of steps (N consecutive nexts become a jump of N files), 
+//   reverse and invert are kept as a parity (two reverses cancel out) and randoms collapse into one
+// Written by the audio thread (and cleared by the UI thread), taken as a whole by the worker that claims the channel,
+//   which applies the preset steps, then the shape steps, then reverse, invert and random; for that fixed order to
+//   give the result of the requests' order, a file step drops what it replaces when it comes in (see addFileSteps())
+struct ChannelWork {
+	static const int MAX_STEPS = 64;
+	
+	std::atomic<int> presetSteps{0};// negative for prev
+	std::atomic<int> shapeSteps{0};
+	std::atomic<int> reverseParity{0};
+	std::atomic<int> invertParity{0};
+	std::atomic<bool> randomize{false};
+	std::atomic<bool> withHistory{false};
+	// staged file requests (deferred until EOC), not seen by the workers until executeIfStaged()
+	std::atomic<int> stagedPresetSteps{0};
+	std::atomic<int> stagedShapeSteps{0};
+	std::atomic<bool> stagedWithHistory{false};
+	std::atomic<bool> busy{false};// claimed by a worker, which clears it once the channel has its new preset or shape
+	
+	static void addSteps(std::atomic<int>* steps, int step) {
+		int cur = steps->load();
+		while (!steps->compare_exchange_weak(cur, clamp(cur + step, -MAX_STEPS, MAX_STEPS))) {}
+	}
+	
+	void addFileSteps(bool isPreset, int step) {
+		// the new file replaces the shape, so reverse, invert and random requested before it are dropped,
+		//   as are the shape steps in the case of a preset (the preset brings its own shape)
+		reverseParity.store(0);
+		invertParity.store(0);
+		randomize.store(false);
+		if (isPreset) {
+			shapeSteps.store(0);
+		}
+		addSteps(isPreset ? &presetSteps : &shapeSteps, step);
+	}
+	
+	bool hasWork() {
+		return presetSteps.load() != 0 || shapeSteps.load() != 0 || reverseParity.load() != 0 || invertParity.load() != 0 || randomize.load();
+	}
+	
+	bool claim() {
+		bool expected = false;
+		return busy.compare_exchange_strong(expected, true);
+	}
+	
+	void clear() {
+		presetSteps.store(0);
+		shapeSteps.store(0);
+		reverseParity.store(0);
+		invertParity.store(0);
+		randomize.store(false);
+		withHistory.store(false);
+		stagedPresetSteps.store(0);
+		stagedShapeSteps.store(0);
+		stagedWithHistory.store(false);
+	}
+};
 
 
 class PresetAndShapeManager {
+	static const int NUM_WORKERS = 2;// so that a slow file in one channel doesn't hold up the others
+	
 	// general
 	std::vector<std::string> factoryPresetVector;
 	std::vector<std::string> factoryShapeVector;
 	Channel* channels = nullptr;
 	Channel* channelDirtyCacheSrc =  nullptr;
 	
-	// worker
-	int workType[8] = {};// this value is not used
-	bool withHistory[8] = {};
-	int8_t requestWork[8] = {};
-	std::condition_variable cv;// https://thispointer.com//c11-multithreading-part-7-condition-variables-explained/
-	std::mutex mtx;
-	std::thread worker;// http://www.cplusplus.com/reference/thread/thread/thread/
-	bool requestStop = false;
+	// workers
+	PresetLibrary library;// shared by the workers
+	ChannelWork channelWork[8];
+	WorkSignal signal;// set by the audio and UI threads when they add work
+	// dirty reference: the preset or shape file of the current channel, loaded by a worker into channelDirtyCacheSrc 
+	//   and reduced to a hash; the path and flags are written by the UI and read by the worker only while state is DRS_LOADING
+	std::string dirtyRefPath;
+	bool dirtyRefIsPreset = false;
+	std::atomic<int> dirtyRefState;
+	std::atomic<bool> dirtyRefInvalid;// file was saved, or preset path was reset
+	std::atomic<bool> dirtyRefBusy;// claimed by a worker
+	uint64_t dirtyRefHash = 0;
+	bool dirtyRefUnsupportedSync = false;
+	std::thread workers[NUM_WORKERS];// http://www.cplusplus.com/reference/thread/thread/thread/
 	Context* context = nullptr;
+	
+	// batch processing of a folder (menu), run in its own thread so that the UI is not blocked while the files are processed
+	std::thread batchThread;
+	std::atomic<bool> batchRunning;
+	std::atomic<bool> batchCancel;// set when the manager is deleted, so that a running batch stops after its current files
+	std::atomic<bool> batchDone;// batchResultText is ready to be shown by the UI
+	std::string batchResultText;// written by the batch thread before batchDone is set
+	
+	void loadDirtyRef();
+	void serveChannel(int chan, std::vector<std::string>* prefetchPaths);
+	void loadNeighbour(Channel* channel, bool isPreset, int steps, bool withHistory, std::vector<std::string>* prefetchPaths);
 		
 	// other
 	PackedBytes4* miscSettings3;
@@ -54,11 +140,14 @@ class PresetAndShapeManager {
 	
 	
 	~PresetAndShapeManager() {
-		std::unique_lock<std::mutex> lk(mtx);
-		requestStop = true;
-		lk.unlock();
-		cv.notify_one();
-		worker.join();
+		batchCancel.store(true);
+		if (batchThread.joinable()) {
+			batchThread.join();
+		}
+		signal.stop();
+		for (int w = 0; w < NUM_WORKERS; w++) {
+			workers[w].join();
+		}
 	}
 	
 
@@ -66,9 +155,20 @@ class PresetAndShapeManager {
 	
 
 	void executeIfStaged(int c) {
-		if (requestWork[c] == WS_STAGED) {
-			requestWork[c] = WS_TODO;
-			cv.notify_one();
+		ChannelWork* cw = &channelWork[c];
+		int stagedPresetSteps = cw->stagedPresetSteps.exchange(0);
+		int stagedShapeSteps = cw->stagedShapeSteps.exchange(0);
+		if (stagedPresetSteps != 0 || stagedShapeSteps != 0) {
+			if (cw->stagedWithHistory.exchange(false)) {
+				cw->withHistory.store(true);
+			}
+			if (stagedPresetSteps != 0) {
+				cw->addFileSteps(true, stagedPresetSteps);
+			}
+			if (stagedShapeSteps != 0) {
+				cw->addFileSteps(false, stagedShapeSteps);
+			}
+			signal.notify();
 		}
 	}
 	void executeAllIfStaged() {
@@ -79,22 +179,48 @@ class PresetAndShapeManager {
 	
 	
 	void cleanWorkload(int c) {
-		requestWork[c] = WS_NONE;
+		channelWork[c].clear();
 	}
 	void clearAllWorkloads() {
 		for (int c = 0; c < 8; c++) {
-			requestWork[c] = WS_NONE;
+			channelWork[c].clear();
 		}
 	}
 	
 	
+	bool isAnyWorkTodo() {
+		// work that a worker can start now (channels that are already being served are not counted)
+		if (dirtyRefState.load() == DRS_LOADING && !dirtyRefBusy.load()) {
+			return true;
+		}
+		for (int c = 0; c < 8; c++) {
+			if (channelWork[c].hasWork() && !channelWork[c].busy.load()) {
+				return true;
+			}
+		}
+		return false;
+	}
+	
+	
 	bool isDeferred(int c, int arrow) {
-		if (requestWork[c] != WS_STAGED) return false;
-		return arrow == workType[c];
+		int staged = arrow <= WT_NEXT_PRESET ? channelWork[c].stagedPresetSteps.load() : channelWork[c].stagedShapeSteps.load();
+		return (arrow == WT_PREV_PRESET || arrow == WT_PREV_SHAPE) ? staged < 0 : staged > 0;
 	}
 	
 	
 	void executeOrStageWorkload(int c, int _workType, bool _withHistory, bool stage);
+	
+	int getDirtyRef(const std::string& path, bool isPreset, uint64_t* hash, bool* unsupportedSync);
+	
+	void invalidateDirtyRef() {
+		dirtyRefInvalid.store(true);
+	}
+	
+	bool isBatchRunning() {
+		return batchRunning.load();
+	}
+	bool startBatch(const std::string& dirPath, const PresetBatchOptions& options);
+	void showBatchResultIfDone();
 
 	void file_worker();
 
@@ -0,0 +1,176 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#include "PresetBatch.hpp"
+#include "PresetAndShapeManager.hpp"
+#include <thread>
+
+
+static const int MAX_BATCH_DEPTH = 8;// folder levels scanned below the given folder
+
+
+// scratch channel of a batch thread, set up like the module's channelDirtyCache
+struct BatchChannel {
+	Param params[NUM_CHAN_PARAMS] = {};
+	Input inputs[NUM_SM_INPUTS];
+	Output outputs[NUM_SM_OUTPUTS];
+	bool running = false;
+	Channel channel;
+	
+	BatchChannel() {
+		channel.construct(0, &running, NULL, NULL, inputs, outputs, params, NULL, NULL);
+	}
+};
+
+
+struct BatchWork {
+	const std::vector<std::string>* paths;
+	const PresetBatchOptions* options;
+	Context* context;
+	const std::atomic<bool>* cancel;// can be nullptr
+	std::atomic<int> nextIndex;
+	std::atomic<int> numWritten;
+	std::atomic<int> numFailed;
+	std::mutex parseTimeMutex;
+	double parseTime = 0.0;
+};
+
+
+static bool processBatchFile(const std::string& path, BatchChannel* bc, const PresetBatchOptions& options, double* parseTime) {
+	// returns success
+	double startTime = system::getTime();
+	FILE* file = std::fopen(path.c_str(), "r");
+	if (!file) {
+		WARN("ShapeMaster batch: can't open %s", path.c_str());
+		return false;
+	}
+	json_error_t error;
+	json_t* presetOrShapeFileJ = json_loadf(file, 0, &error);
+	std::fclose(file);
+	if (!presetOrShapeFileJ) {
+		WARN("ShapeMaster batch: JSON parsing error at %s %d:%d %s", path.c_str(), error.line, error.column, error.text);
+		return false;
+	}
+	json_t *channelPresetOrShapeJ = json_object_get(presetOrShapeFileJ, options.isPreset ? "ShapeMaster channel preset" : "ShapeMaster shape");
+	if (!channelPresetOrShapeJ) {
+		WARN("ShapeMaster batch: %s is not a ShapeMaster %s file", path.c_str(), options.isPreset ? "channel preset" : "shape");
+		json_decref(presetOrShapeFileJ);
+		return false;
+	}
+	
+	// start from the defaults for each file, so that keys that are missing in a file don't come from the previous one
+	if (options.isPreset) {
+		bc->channel.onReset(true);
+		bc->channel.dataFromJsonChannel(channelPresetOrShapeJ, WITH_PARAMS, true, WITHOUT_FULL_SETTINGS);// as a dirty cache load, no play head or process state to reset
+	}
+	else {
+		bc->channel.resetShape();
+		bc->channel.dataFromJsonShape(channelPresetOrShapeJ);
+	}
+	json_decref(presetOrShapeFileJ);
+	*parseTime += system::getTime() - startTime;
+	
+	if (options.isPreset) {
+		if (options.stripSync) {
+			bc->params[SYNC_PARAM].setValue(0.0f);
+			bc->params[LOCK_PARAM].setValue(0.0f);
+		}
+		if (options.rangeIndex >= 0) {
+			bc->channel.setRangeIndex(options.rangeIndex, false);
+		}
+	}
+	
+	if (options.write && !writePresetOrShapeFile(path, &bc->channel, options.isPreset)) {
+		WARN("ShapeMaster batch: can't write %s", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+static void batchWorker(BatchWork* work) {
+	contextSet(work->context);
+	BatchChannel* bc = new BatchChannel();// Channel is large, keep it off the thread's stack
+	double parseTime = 0.0;
+	int numPaths = (int)work->paths->size();
+	for (int i = work->nextIndex++; i < numPaths && !(work->cancel && work->cancel->load()); i = work->nextIndex++) {
+		if (processBatchFile((*work->paths)[i], bc, *work->options, &parseTime)) {
+			if (work->options->write) {
+				work->numWritten++;
+			}
+		}
+		else {
+			work->numFailed++;
+		}
+	}
+	delete bc;
+	std::lock_guard<std::mutex> lk(work->parseTimeMutex);
+	work->parseTime += parseTime;
+}
+
+
+PresetBatchResult runPresetBatch(const std::string& dirPath, const PresetBatchOptions& options, const std::atomic<bool>* cancel) {
+	// blocks until all files are processed, or until the ones being processed are done when cancel is set
+	PresetBatchResult result;
+	double startTime = system::getTime();
+	
+	std::string ext = options.isPreset ? ".smpr" : ".smsh";
+	std::vector<std::string> paths;
+	for (const std::string& entry : system::getEntries(dirPath, MAX_BATCH_DEPTH)) {
+		if (system::getExtension(entry) == ext && system::isFile(entry)) {
+			paths.push_back(entry);
+		}
+	}
+	std::sort(paths.begin(), paths.end());
+	result.numFiles = (int)paths.size();
+	if (paths.empty()) {
+		return result;
+	}
+	
+	BatchWork work;
+	work.paths = &paths;
+	work.options = &options;
+	work.context = contextGet();
+	work.cancel = cancel;
+	work.nextIndex = 0;
+	work.numWritten = 0;
+	work.numFailed = 0;
+	
+	int numThreads = (int)std::thread::hardware_concurrency() - 1;// leave a core for the audio and UI threads
+	numThreads = clamp(numThreads, 1, (int)paths.size());
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; t++) {
+		threads.push_back(std::thread(batchWorker, &work));
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	
+	result.numWritten = work.numWritten;
+	result.numFailed = work.numFailed;
+	result.numThreads = numThreads;
+	result.canceled = cancel && cancel->load();
+	result.parseTime = work.parseTime;
+	result.totalTime = system::getTime() - startTime;
+	INFO("ShapeMaster batch: %s", presetBatchResultText(result, options).c_str());
+	return result;
+}
+
+
+std::string presetBatchResultText(const PresetBatchResult& result, const PresetBatchOptions& options) {
+	std::string kind = options.isPreset ? "preset" : "shape";
+	if (result.numFiles == 0) {
+		return string::f("no %s files found", kind.c_str());
+	}
+	std::string text = string::f("%i %s file(s), %i written, %i failed", result.numFiles, kind.c_str(), result.numWritten, result.numFailed);
+	if (result.canceled) {
+		text += ", canceled";
+	}
+	text += string::f(" (%i threads, %.1f ms total, %.3f ms parsing per file)", result.numThreads, result.totalTime * 1000.0, result.parseTime * 1000.0 / result.numFiles);
+	return text;
+}
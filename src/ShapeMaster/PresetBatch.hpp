@@ -0,0 +1,42 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include "Channel.hpp"
+
+
+// Batch processing of a folder tree of presets (.smpr) or shapes (.smsh), without a live channel and without the GUI:
+//   each file is parsed into a scratch channel, modified as requested, and written back like a saved preset or shape
+//   (the .tmp and rename scheme of savePresetOrShape()); the files are shared among worker threads, one per core but one
+//   (which is left for the audio and UI threads)
+// Errors are only counted and logged, no dialogs are shown (safe to run from any thread, as long as a Rack context exists),
+//   the menu runs it in PresetAndShapeManager's batch thread and the UI shows the result when it's done
+// When the optional cancel flag is set, the workers stop after the files they are processing (the others are left as is)
+
+struct PresetBatchOptions {
+	bool isPreset = true;
+	bool write = true;// false only parses the files (benchmark)
+	bool stripSync = false;// presets only, turns off sync and lock
+	int8_t rangeIndex = -1;// presets only, -1 to keep the range of each preset
+};
+
+struct PresetBatchResult {
+	int numFiles = 0;
+	int numWritten = 0;
+	int numFailed = 0;
+	int numThreads = 0;
+	bool canceled = false;
+	double parseTime = 0.0;// in seconds, summed over the threads
+	double totalTime = 0.0;// in seconds, wall clock
+};
+
+
+PresetBatchResult runPresetBatch(const std::string& dirPath, const PresetBatchOptions& options, const std::atomic<bool>* cancel = nullptr);
+
+std::string presetBatchResultText(const PresetBatchResult& result, const PresetBatchOptions& options);
@@ -0,0 +1,157 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#include "PresetLibrary.hpp"
+
+
+void PresetLibrary::clear() {
+	std::lock_guard<std::mutex> lk(mtx);
+	listings.clear();
+	for (Parsed& p : parsed) {
+		json_decref(p.fileJ);
+	}
+	parsed.clear();
+}
+
+
+const PresetLibrary::Listing* PresetLibrary::getListing(const std::string& dir, const std::string& ext) {
+	// mtx must be held by the caller for as long as the returned listing is used
+	// adding, removing or renaming a file changes the modified time of its folder, so a stat is enough to validate a listing
+	double modifiedTime = system::getModifiedTime(dir);
+	useCount++;
+
+	Listing* listing = nullptr;
+	for (Listing& l : listings) {
+		if (l.dir == dir && l.ext == ext) {
+			listing = &l;
+			break;
+		}
+	}
+	if (listing && listing->modifiedTime == modifiedTime) {
+		listing->lastUse = useCount;
+		return listing;
+	}
+
+	if (!listing) {
+		if ((int)listings.size() < MAX_LISTINGS) {
+			listings.push_back(Listing());
+			listing = &listings.back();
+		}
+		else {
+			listing = &listings[0];
+			for (Listing& l : listings) {
+				if (l.lastUse < listing->lastUse) {
+					listing = &l;
+				}
+			}
+		}
+		listing->dir = dir;
+		listing->ext = ext;
+	}
+	listing->modifiedTime = modifiedTime;
+	listing->lastUse = useCount;
+	listing->files.clear();
+	std::vector<std::string> entries = system::getEntries(dir);
+	std::sort(entries.begin(), entries.end());
+	for (std::string& entry : entries) {
+		if (system::getExtension(entry) == ext && system::isFile(entry)) {
+			listing->files.push_back(entry);
+		}
+	}
+	return listing;
+}
+
+
+std::string PresetLibrary::getNeighbour(const std::string& path, const std::string& ext, bool getPrev, int distance) {
+	std::lock_guard<std::mutex> lk(mtx);
+	const Listing* listing = getListing(system::getDirectory(path), ext);
+	const std::vector<std::string>& files = listing->files;
+	auto it = std::lower_bound(files.begin(), files.end(), path);// listing is sorted
+	if (it == files.end() || *it != path) {
+		return "";
+	}
+	int size = (int)files.size();
+	int newIndex = (int)(it - files.begin()) + (getPrev ? -distance : distance) % size;
+	newIndex = (newIndex + size) % size;
+	return files[newIndex];
+}
+
+
+json_t* PresetLibrary::getParsed(const std::string& path) {
+	double modifiedTime = system::getModifiedTime(path);
+	int64_t size = system::getFileSize(path);
+
+	std::unique_lock<std::mutex> lk(mtx);
+	useCount++;
+	for (Parsed& p : parsed) {
+		if (p.path == path) {
+			if (p.modifiedTime == modifiedTime && p.size == size) {
+				p.lastUse = useCount;
+				json_incref(p.fileJ);
+				return p.fileJ;
+			}
+			// stale, drop it and reparse
+			json_decref(p.fileJ);
+			p = parsed.back();
+			parsed.pop_back();
+			break;
+		}
+	}
+	lk.unlock();
+
+	// parse without the lock, so that the other workers can use the cache in the meantime
+	FILE* file = std::fopen(path.c_str(), "r");
+	if (!file) {
+		return NULL;
+	}
+	json_error_t error;
+	json_t* fileJ = json_loadf(file, 0, &error);
+	std::fclose(file);
+	if (!fileJ) {
+		return NULL;
+	}
+
+	lk.lock();
+	useCount++;
+	for (Parsed& p : parsed) {
+		if (p.path == path) {
+			// another worker parsed the same file in the meantime, keep the cached one
+			p.lastUse = useCount;
+			return fileJ;
+		}
+	}
+	if ((int)parsed.size() >= MAX_PARSED) {
+		Parsed* lru = &parsed[0];
+		for (Parsed& p : parsed) {
+			if (p.lastUse < lru->lastUse) {
+				lru = &p;
+			}
+		}
+		json_decref(lru->fileJ);
+		*lru = parsed.back();
+		parsed.pop_back();
+	}
+	Parsed newParsed;
+	newParsed.path = path;
+	newParsed.modifiedTime = modifiedTime;
+	newParsed.size = size;
+	newParsed.fileJ = fileJ;
+	newParsed.lastUse = useCount;
+	parsed.push_back(newParsed);
+
+	json_incref(fileJ);// one ref for the cache, one for the caller
+	return fileJ;
+}
+
+
+void PresetLibrary::prefetch(const std::string& path) {
+	json_t* fileJ = getParsed(path);
+	if (fileJ) {
+		json_decref(fileJ);
+	}
+}
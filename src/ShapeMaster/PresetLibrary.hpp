@@ -0,0 +1,65 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include "rack.hpp"
+
+using namespace rack;
+
+
+// Index of the user preset and shape folders, for the prev/next buttons and CVs
+// - sorted listings of the .smpr or .smsh files of a folder, refreshed when the folder's modified time changes
+// - LRU cache of the parsed files, an entry is reparsed when its file's modified time or size changes
+// Shared by the PresetAndShapeManager's workers: the caches are behind a mutex, but files are parsed outside of it
+class PresetLibrary {
+	static const int MAX_LISTINGS = 8;
+	static const int MAX_PARSED = 16;
+
+	struct Listing {
+		std::string dir;
+		std::string ext;
+		double modifiedTime = 0.0;
+		std::vector<std::string> files;
+		uint64_t lastUse = 0;
+	};
+
+	struct Parsed {
+		std::string path;
+		double modifiedTime = 0.0;
+		int64_t size = 0;
+		json_t* fileJ = nullptr;
+		uint64_t lastUse = 0;
+	};
+
+	std::vector<Listing> listings;
+	std::vector<Parsed> parsed;
+	uint64_t useCount = 0;
+	std::mutex mtx;
+
+
+	const Listing* getListing(const std::string& dir, const std::string& ext);
+
+
+	public:
+
+	~PresetLibrary() {
+		clear();
+	}
+
+	void clear();
+
+	std::string getNeighbour(const std::string& path, const std::string& ext, bool getPrev, int distance = 1);
+	// returns the path of the file that is distance files before or after path in its folder, with wrap-around,
+	//   or an empty string when path is not in its folder's listing
+
+	json_t* getParsed(const std::string& path);
+	// returns a new reference (caller must json_decref() it), or NULL when the file can't be opened or parsed
+
+	void prefetch(const std::string& path);
+};
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "../MindMeldModular.hpp"
+#include "DirtyHash.hpp"
 
 
 struct RandomSettings {
@@ -114,20 +115,19 @@ struct RandomSettings {
 		if (deltaModeJ) deltaMode = json_integer_value(deltaModeJ);
 	}
 	
-	bool isDirty(const RandomSettings* refRand) {
-		if (std::round(numNodesMin) != std::round(refRand->numNodesMin)) return true;// float value with decimals, but meaning is int
-		if (std::round(numNodesMax) != std::round(refRand->numNodesMax)) return true;// float value with decimals, but meaning is int
-		if (std::round(ctrlMax * 10.0f) != std::round(refRand->ctrlMax * 10.0f)) return true;// percent comparison to one decimal
-		if (std::round(zeroV * 10.0f) != std::round(refRand->zeroV * 10.0f)) return true;// percent comparison to one decimal
-		if (std::round(maxV * 10.0f) != std::round(refRand->maxV * 10.0f)) return true;// percent comparison to one decimal
-		if (std::round(deltaChange * 10.0f) != std::round(refRand->deltaChange * 10.0f)) return true;// percent comparison to one decimal
-		if (std::round(deltaNodes * 10.0f) != std::round(refRand->deltaNodes * 10.0f)) return true;// percent comparison to one decimal
-		if (scale != refRand->scale) return true;// int comparison
-		if (stepped != refRand->stepped) return true;// int comparison
-		if (grid != refRand->grid) return true;// int comparison
-		if (quantized != refRand->quantized) return true;// int comparison
-		if (deltaMode != refRand->deltaMode) return true;// int comparison
-		return false;
+	void addToDirtyHash(DirtyHash* dh) const {
+		dh->addRounded(numNodesMin);// float value with decimals, but meaning is int
+		dh->addRounded(numNodesMax);// float value with decimals, but meaning is int
+		dh->addRounded(ctrlMax * 10.0f);// percent to one decimal
+		dh->addRounded(zeroV * 10.0f);// percent to one decimal
+		dh->addRounded(maxV * 10.0f);// percent to one decimal
+		dh->addRounded(deltaChange * 10.0f);// percent to one decimal
+		dh->addRounded(deltaNodes * 10.0f);// percent to one decimal
+		dh->add((int64_t)scale);
+		dh->add((int64_t)stepped);
+		dh->add((int64_t)grid);
+		dh->add((int64_t)quantized);
+		dh->add((int64_t)deltaMode);
 	}
 };
 
@@ -26,8 +26,59 @@ float Shape::applyScalingToCtrl(float ctrl, float exponent) {
 }
 
 
+void Shape::compileToProcessTable() {
+	// called at the end of the outermost edit, by the thread that modifies the shape
+	ShapeTableSlot* slot = processTable->getWriteSlot();
+	for (int p = 0; p < numPts - 1; p++) {
+		ShapeSegment* seg = &slot->segs[p];
+		float dx = std::fabs(points[p + 1].x - points[p].x);
+		seg->x0 = points[p].x;
+		seg->y0 = points[p].y;
+		seg->dy = points[p + 1].y - points[p].y;
+		seg->k = 0.0f;
+		if (dx < 1e-6f) {
+			seg->invDx = 0.0f;
+			seg->mode = ShapeSegment::SEG_FLAT;
+			continue;
+		}
+		seg->invDx = 1.0f / dx;
+		float c = ctrl[p];
+		if (type[p] != 0) {
+			seg->k = 1.98f * c - 0.99f;// see _y2()
+			seg->mode = ShapeSegment::SEG_SCURVE;
+		}
+		else if (c == 0.5f) {
+			seg->mode = ShapeSegment::SEG_LINEAR;
+		}
+		else {
+			// see _y(), (2c)^(2(1-x)) is evaluated as exp2(2*log2(2c)*(1-x))
+			bool mirror = c > 0.5f;
+			if (mirror) {
+				c = 1.0f - c;
+			}
+			seg->k = 2.0f * std::log2(2.0f * c);
+			seg->mode = mirror ? ShapeSegment::SEG_SMOOTH_MIRROR : ShapeSegment::SEG_SMOOTH;
+		}
+	}
+	// last node, only used for its x0 and y0
+	ShapeSegment* seg = &slot->segs[numPts - 1];
+	seg->x0 = points[numPts - 1].x;
+	seg->invDx = 0.0f;
+	seg->y0 = points[numPts - 1].y;
+	seg->dy = 0.0f;
+	seg->k = 0.0f;
+	seg->mode = ShapeSegment::SEG_FLAT;
+	slot->numPts = numPts;
+	slot->buildIndex();
+	if (wavetable) {
+		wavetable->setSource(slot);
+	}
+	processTable->publish();
+}
+
+
 void Shape::onReset() {
-	lockShapeBlocking();
+	beginEdit();
 	points[0].x = 0.0f;// must be 0.0f
 	points[0].y = 0.0f;
 	points[1].x = 0.5f;
@@ -39,14 +90,12 @@ void Shape::onReset() {
 		type[p] = 0;
 	}
 	numPts = 3;
-	pc = 0;// not saved
-	pcDelta = 0;// not saved
-	unlockShape();
+	endEdit();
 }
 
 
 void Shape::initMinPts() {
-	lockShapeBlocking();
+	beginEdit();
 	for (int p = 0; p < 2; p++) {
 		points[p].y = 0.0f;
 		ctrl[p] = 0.5f;// default is 50% which is linear
@@ -54,9 +103,7 @@ void Shape::initMinPts() {
 	}
 	points[1].x = 1.0f;
 	numPts = 2;
-	pc = 0;
-	pcDelta = 0;
-	unlockShape();
+	endEdit();
 }
 
 
@@ -66,6 +113,7 @@ void Shape::setPointWithSafety(int p, Vec newPt, int xQuant, int yQuant, bool de
 	//   points[p - 1].x + SAFETY  <  points[p].x  <  points[p + 1].x - SAFETY
 	// quantize y to range if wanted
 	newPt.y = normalizedQuantize(newPt.y, yQuant);
+	beginEdit();
 	if (p == 0 || p == (numPts - 1)) {
 		if (!decoupledFirstLast) {
 			points[0].y = newPt.y;
@@ -83,6 +131,7 @@ void Shape::setPointWithSafety(int p, Vec newPt, int xQuant, int yQuant, bool de
 		points[p].x = clamp(newPt.x, points[p - 1].x + SAFETY, points[p + 1].x - SAFETY);
 		points[p].y = newPt.y;
 	}
+	endEdit();
 }
 
 
@@ -110,11 +159,10 @@ int Shape::insertPointWithSafetyAndBlock(Vec newPt, bool withHistory, bool withS
 				// test safety
 				if (newPt.x > (points[i - 1].x + safety) && newPt.x < (points[i].x - safety)) {
 					// here we have found the location of new point and safety is good
-					lockShapeBlocking();
+					beginEdit();
 					insertPoint(i, newPt, newCtrl, newType);
-					if (pc > i) pc++;
 					p = i;
-					unlockShape();
+					endEdit();
 					if (withHistory) {
 						// Push InsertPointChange history action
 						InsertPointChange* h = new InsertPointChange;
@@ -140,7 +188,6 @@ void Shape::deletePoint(int p) {
 			type[i] = type[i + 1];
 		}
 		numPts--;
-		if (pc > p) pc--;
 	}		
 }
 void Shape::deletePointWithBlock(int p, bool withHistory) {
@@ -154,9 +201,9 @@ void Shape::deletePointWithBlock(int p, bool withHistory) {
 		h->oldPt = p;	
 		APP->history->push(h);
 	}
-	lockShapeBlocking();
+	beginEdit();
 	deletePoint(p);
-	unlockShape();
+	endEdit();
 }
 
 
@@ -189,7 +236,7 @@ void Shape::makeStep(int p, Vec vecStepPt, int xQuant, int yQuant) {
 		}
 		
 		
-		lockShapeBlocking();
+		beginEdit();
 		
 		
 		// left
@@ -265,7 +312,7 @@ void Shape::makeStep(int p, Vec vecStepPt, int xQuant, int yQuant) {
 			points[numPts - 1].y = yStep;
 		}
 		
-		unlockShape();
+		endEdit();
 	}
 }
 
@@ -278,8 +325,10 @@ void Shape::makeLinear(int p) {
 	h->oldCtrl = ctrl[p];
 	h->oldType = type[p];
 	
+	beginEdit();
 	ctrl[p] = 0.5f;
 	type[p] = 0;
+	endEdit();
 
 	h->newCtrl = ctrl[p];
 	h->newType = type[p];
@@ -289,34 +338,128 @@ void Shape::makeLinear(int p) {
 
 
 
-json_t* Shape::dataToJsonShape() {
+// Binary shape (base64 in the "bin" member of the shape's json), version 1, little-endian (as are all the platforms Rack runs on):
+//   magic "SMSB" (4 bytes), version (uint8), reserved (3 bytes), numPts (int32),
+//   points (numPts * 2 float32, x and y interleaved as in Vec), ctrl (numPts float32), type (numPts int8)
+static const uint8_t SHAPE_BIN_MAGIC[4] = {'S', 'M', 'S', 'B'};
+static const uint8_t SHAPE_BIN_VERSION = 1;
+static const size_t SHAPE_BIN_HEADER_SIZE = 12;
+static const size_t SHAPE_BIN_BYTES_PER_PT = sizeof(Vec) + sizeof(float) + sizeof(int8_t);
+static_assert(sizeof(Vec) == 2 * sizeof(float), "binary shape expects Vec to be two packed floats");
+
+
+json_t* Shape::dataToJsonShape(bool withBinShape) {
+	// withBinShape: compact "bin" member only, which ShapeMaster 2.5.0 and earlier can't read, so it must not be used 
+	//   in preset and shape files, and only in patches when the user asked for it
 	json_t* shapeJ = json_object();
 	
-	// points and isCtrl
-	json_t* pointsXJ = json_array();
-	json_t* pointsYJ = json_array();
-	json_t* ctrlJ    = json_array();
-	json_t* typeJ    = json_array();
+	std::unique_lock<std::recursive_mutex> lk(editMutex);// not an edit, but numPts and the arrays must be coherent
+	if (!withBinShape) {
+		// points and isCtrl
+		json_t* pointsXJ = json_array();
+		json_t* pointsYJ = json_array();
+		json_t* ctrlJ    = json_array();
+		json_t* typeJ    = json_array();
+		for (int p = 0; p < numPts; p++) {
+			json_array_insert_new(pointsXJ, p , json_real(points[p].x));
+			json_array_insert_new(pointsYJ, p , json_real(points[p].y));
+			json_array_insert_new(ctrlJ,    p , json_real(ctrl[p]));
+			json_array_insert_new(typeJ,    p , json_integer(type[p]));
+		}
+		json_object_set_new(shapeJ, "pointsX", pointsXJ);
+		json_object_set_new(shapeJ, "pointsY", pointsYJ);
+		json_object_set_new(shapeJ, "ctrl",    ctrlJ);
+		json_object_set_new(shapeJ, "type",    typeJ);
+
+		// numPts
+		json_object_set_new(shapeJ, "numPts", json_integer(numPts));
+		
+		return shapeJ;
+	}
+	
+	std::vector<uint8_t> data(SHAPE_BIN_HEADER_SIZE + numPts * SHAPE_BIN_BYTES_PER_PT, 0);
+	uint8_t* dest = data.data();
+	std::memcpy(dest, SHAPE_BIN_MAGIC, 4);
+	dest[4] = SHAPE_BIN_VERSION;
+	int32_t numPts32 = numPts;
+	std::memcpy(&dest[8], &numPts32, sizeof(int32_t));
+	dest += SHAPE_BIN_HEADER_SIZE;
+	std::memcpy(dest, points, numPts * sizeof(Vec));
+	dest += numPts * sizeof(Vec);
+	std::memcpy(dest, ctrl, numPts * sizeof(float));
+	dest += numPts * sizeof(float);
+	std::memcpy(dest, type, numPts * sizeof(int8_t));
+	lk.unlock();
+	
+	json_object_set_new(shapeJ, "bin", json_string(string::toBase64(data.data(), data.size()).c_str()));
+
+	return shapeJ;
+}
+
+
+static bool isValidBinaryShape(const uint8_t* src, int numPts) {
+	// the binary data comes from patches, which can't be trusted, and is bulk copied into the shape, so it is checked
+	//   against the invariants of a shape: finite coordinates within [0:1], x non-decreasing from 0.0f to 1.0f,
+	//   ctrl within [MIN_CTRL:1-MIN_CTRL] (0 or 1 gives an infinite curve exponent) and type 0 or 1
+	const uint8_t* ctrlSrc = src + numPts * sizeof(Vec);
+	const uint8_t* typeSrc = ctrlSrc + numPts * sizeof(float);
+	float lastX = 0.0f;
 	for (int p = 0; p < numPts; p++) {
-		json_array_insert_new(pointsXJ, p , json_real(points[p].x));
-		json_array_insert_new(pointsYJ, p , json_real(points[p].y));
-		json_array_insert_new(ctrlJ,    p , json_real(ctrl[p]));
-		json_array_insert_new(typeJ,    p , json_integer(type[p]));
+		Vec pt;
+		float c;
+		std::memcpy(&pt, src + p * sizeof(Vec), sizeof(Vec));
+		std::memcpy(&c, ctrlSrc + p * sizeof(float), sizeof(float));
+		int8_t t = (int8_t)typeSrc[p];
+		// comparisons are false for NaN, so they are written such that NaN fails them
+		if (!(pt.x >= lastX && pt.x <= 1.0f) || !(pt.y >= 0.0f && pt.y <= 1.0f) || !(c >= Shape::MIN_CTRL && c <= 1.0f - Shape::MIN_CTRL) || t < 0 || t > 1) {
+			return false;
+		}
+		lastX = pt.x;
 	}
-	json_object_set_new(shapeJ, "pointsX", pointsXJ);
-	json_object_set_new(shapeJ, "pointsY", pointsYJ);
-	json_object_set_new(shapeJ, "ctrl",    ctrlJ);
-	json_object_set_new(shapeJ, "type",    typeJ);
+	float firstX;
+	std::memcpy(&firstX, src, sizeof(float));
+	return firstX == 0.0f && lastX == 1.0f;
+}
 
-	// numPts
-	json_object_set_new(shapeJ, "numPts", json_integer(numPts));
 
-	return shapeJ;
+bool Shape::dataFromBinaryShape(const std::vector<uint8_t>& data) {
+	// returns false (and shape unchanged) when data is not a valid binary shape of a supported version
+	if (data.size() < SHAPE_BIN_HEADER_SIZE || std::memcmp(data.data(), SHAPE_BIN_MAGIC, 4) != 0 || data[4] != SHAPE_BIN_VERSION) {
+		return false;
+	}
+	int32_t newNumPts;
+	std::memcpy(&newNumPts, &data[8], sizeof(int32_t));
+	if (newNumPts < 2 || newNumPts > MAX_PTS || data.size() != SHAPE_BIN_HEADER_SIZE + newNumPts * SHAPE_BIN_BYTES_PER_PT) {
+		return false;
+	}
+	const uint8_t* src = &data[SHAPE_BIN_HEADER_SIZE];
+	if (!isValidBinaryShape(src, newNumPts)) {
+		return false;
+	}
+	
+	beginEdit();
+	std::memcpy(points, src, newNumPts * sizeof(Vec));
+	src += newNumPts * sizeof(Vec);
+	std::memcpy(ctrl, src, newNumPts * sizeof(float));
+	src += newNumPts * sizeof(float);
+	std::memcpy(type, src, newNumPts * sizeof(int8_t));
+	numPts = newNumPts;
+	endEdit();
+	return true;
 }
 
 
 void Shape::dataFromJsonShape(json_t *shapeJ) {
-	lockShapeBlocking();
+	// binary
+	json_t* binJ = json_object_get(shapeJ, "bin");
+	if (binJ && json_is_string(binJ)) {
+		if (dataFromBinaryShape(string::fromBase64(json_string_value(binJ)))) {
+			return;
+		}
+	}
+	
+	// legacy arrays (shapes and presets saved before 2.5.1, and factory ones)
+	beginEdit();
 	
 	// points
 	json_t* pointsXJ = json_object_get(shapeJ, "pointsX");
@@ -333,7 +476,7 @@ void Shape::dataFromJsonShape(json_t *shapeJ) {
 			if (pointXarrayJ && pointYarrayJ && ctrlArrayJ && typeArrayJ) {
 				points[p].x = json_number_value(pointXarrayJ);
 				points[p].y = json_number_value(pointYarrayJ);
-				ctrl[p]     = json_number_value(ctrlArrayJ);
+				ctrl[p]     = clamp((float)json_number_value(ctrlArrayJ), MIN_CTRL, 1.0f - MIN_CTRL);
 				type[p]     = json_integer_value(typeArrayJ);
 			}
 		}
@@ -343,11 +486,9 @@ void Shape::dataFromJsonShape(json_t *shapeJ) {
 	json_t *numPtsJ = json_object_get(shapeJ, "numPts");
 	if (numPtsJ) {
 		numPts = json_integer_value(numPtsJ);
-		pc = 0;
-		pcDelta = 0;
 	}
 	
-	unlockShape();
+	endEdit();
 }
 
 
@@ -355,31 +496,100 @@ void Shape::dataFromJsonShape(json_t *shapeJ) {
 // ----------------
 
 void Shape::copyShapeTo(Shape* destShape) {
-	destShape->lockShapeBlocking();
+	destShape->beginEdit();
 	memcpy(destShape->points, points, sizeof(Vec) * numPts);
 	memcpy(destShape->ctrl, ctrl, sizeof(float) * numPts);
 	memcpy(destShape->type, type, sizeof(int8_t) * numPts);
 	destShape->numPts = numPts;
-	destShape->pc = 0;
-	destShape->pcDelta = 0;
-	destShape->unlockShape();
+	destShape->endEdit();
 }
 
 
 void Shape::pasteShapeFrom(const Shape* srcShape) {
-	lockShapeBlocking();
+	beginEdit();
 	memcpy(points, srcShape->points, sizeof(Vec) * srcShape->numPts);
 	memcpy(ctrl, srcShape->ctrl, sizeof(float) * srcShape->numPts);
 	memcpy(type, srcShape->type, sizeof(int8_t) * srcShape->numPts);
 	numPts = srcShape->numPts;
-	pc = 0;
-	pcDelta = 0;
-	unlockShape();
+	endEdit();
+}
+
+
+void Shape::getNodes(ShapeNode* dest, int start, int count) {
+	std::lock_guard<std::recursive_mutex> lk(editMutex);
+	for (int i = 0; i < count; i++) {
+		dest[i] = getNode(start + i);
+	}
+}
+
+
+uint64_t Shape::calcNodesHash() {
+	// exact (bitwise) hash of the whole shape, for the undo history to check that a shape is in the state it recorded
+	std::lock_guard<std::recursive_mutex> lk(editMutex);
+	DirtyHash dh;
+	dh.add((int64_t)numPts);
+	for (int p = 0; p < numPts; p++) {
+		uint32_t bits[3];
+		std::memcpy(&bits[0], &points[p].x, sizeof(float));
+		std::memcpy(&bits[1], &points[p].y, sizeof(float));
+		std::memcpy(&bits[2], &ctrl[p], sizeof(float));
+		dh.add((int64_t)bits[0] | ((int64_t)bits[1] << 32));
+		dh.add((int64_t)bits[2] | ((int64_t)type[p] << 32));
+	}
+	return dh.hash;
+}
+
+
+bool Shape::replaceNodes(int start, int numOld, const ShapeNode* newNodes, int numNew, uint64_t expectedHash) {
+	// replaces the numOld points starting at start with the numNew given ones, the points after them are shifted accordingly
+	// returns false (and does nothing) when the shape is not in the state that the range was recorded in (expectedHash), 
+	//   which happens when the shape was changed by something that has no history (CV, file loads by CV, etc.),
+	//   or when the result would not have its x in order
+	beginEdit();
+	int newNumPts = numPts - numOld + numNew;
+	bool fits = start >= 0 && numOld >= 0 && numNew >= 0 && (start + numOld) <= numPts && newNumPts >= 2 && newNumPts <= MAX_PTS;
+	fits = fits && calcNodesHash() == expectedHash;
+	if (fits) {
+		// x must stay in order across the replaced range and its neighbours
+		float lastX = start > 0 ? points[start - 1].x : 0.0f;
+		for (int i = 0; i < numNew && fits; i++) {
+			fits = newNodes[i].point.x >= lastX;
+			lastX = newNodes[i].point.x;
+		}
+		if (fits && start + numOld < numPts) {
+			fits = points[start + numOld].x >= lastX;
+		}
+	}
+	if (fits) {
+		int numTail = numPts - (start + numOld);
+		int srcTail = start + numOld;
+		int destTail = start + numNew;
+		memmove(&points[destTail], &points[srcTail], sizeof(Vec) * numTail);
+		memmove(&ctrl[destTail], &ctrl[srcTail], sizeof(float) * numTail);
+		memmove(&type[destTail], &type[srcTail], sizeof(int8_t) * numTail);
+		for (int i = 0; i < numNew; i++) {
+			writePoint(start + i, newNodes[i].point, newNodes[i].ctrl, newNodes[i].type);
+		}
+		numPts = newNumPts;
+	}
+	endEdit();
+	return fits;
+}
+
+
+void Shape::setNodes(const ShapeNode* nodes, int num) {
+	// replaces the whole shape, the nodes must have been taken from a shape (undo history) so that they follow the invariants
+	beginEdit();
+	for (int p = 0; p < num; p++) {
+		writePoint(p, nodes[p].point, nodes[p].ctrl, nodes[p].type);
+	}
+	numPts = num;
+	endEdit();
 }
 
 
 void Shape::reverseShape() {	
-	lockShapeBlocking();
+	beginEdit();
 	
 	// do first and last if ever decoupledFirstLast is on
 	float tmpY = points[0].y;
@@ -426,19 +636,18 @@ void Shape::reverseShape() {
 		ctrl[p] = 1.0f - ctrl[p];
 	}
 	
-	pc = (numPts - 1) >> 1;
-	unlockShape();
+	endEdit();
 }
 
 
 void Shape::invertShape() {
-	lockShapeBlocking();
+	beginEdit();
 	
 	for (int i = 0; i < numPts; i++) {
 		points[i].y = 1.0f - points[i].y;
 	}
 	
-	unlockShape();	
+	endEdit();	
 }
 
 
@@ -488,6 +697,7 @@ struct SegmentPair {
 };
 
 void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX, int8_t rangeIndex, bool decoupledFirstLast) {
+	beginEdit();
 	if (randomSettings->deltaMode != 0) {
 		// delta mode randomization (aka vertical randomization)
 		std::vector<SegmentPair> ptSeg;
@@ -525,7 +735,7 @@ void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX,
 			}	
 		}
 		
-		lockShapeBlocking();
+		beginEdit();
 		
 		int numTruePts = numPts - (decoupledFirstLast ? 0 : 1);
 				
@@ -597,7 +807,7 @@ void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX,
 				points[numPts - 1].y = points[0].y;
 			}
 		}
-		unlockShape();
+		endEdit();
 	}
 	else {
 		// non delta mode randomization
@@ -622,7 +832,7 @@ void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX,
 		}
 		
 		if (randomSettings->stepped) {
-			lockShapeBlocking();
+			beginEdit();
 			if (!randomSettings->grid) {
 				for (int rp = numPtsRnd - 1; rp >= 0; rp--) {
 					float rndCv = calcRandCv(randomSettings, restCv, rangeValues[rangeIndex]);
@@ -645,7 +855,7 @@ void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX,
 						points[numPts - 1].y = rndCv;
 					}	
 					if (slide) {
-						setCtrlWithSafety(rp > 0 ? 1 : 0, calcRndCtrl(90.0f));// max ctrl is 90% in this case, don't want too extreme curves
+						writeCtrlWithSafety(rp > 0 ? 1 : 0, calcRndCtrl(90.0f));// max ctrl is 90% in this case, don't want too extreme curves
 					}
 				}
 			}
@@ -660,7 +870,7 @@ void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX,
 					if (rp > 0) { 
 						insertPoint(nextInsPt, Vec(xStepL, rndCv));
 						if (slide) {
-							setCtrlWithSafety(nextInsPt, calcRndCtrl(90.0f));// max ctrl is 90% in this case, don't want too extreme curves
+							writeCtrlWithSafety(nextInsPt, calcRndCtrl(90.0f));// max ctrl is 90% in this case, don't want too extreme curves
 						}
 						nextInsPt++;
 					}
@@ -671,7 +881,7 @@ void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX,
 						type[0] = 0;
 						points[numPts - 1].y = rndCv;
 						if (slide) {
-							setCtrlWithSafety(0, calcRndCtrl(90.0f));// max ctrl is 90% in this case, don't want too extreme curves
+							writeCtrlWithSafety(0, calcRndCtrl(90.0f));// max ctrl is 90% in this case, don't want too extreme curves
 						}
 					}	
 					onePos = bjorklund.nextOne(onePos);
@@ -693,7 +903,7 @@ void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX,
 				points[numPts - 2].x = 1.0f;
 				numPts--;
 			}
-			unlockShape();
+			endEdit();
 		}
 		else {// not stepped
 			if (!randomSettings->grid) {
@@ -728,28 +938,27 @@ void Shape::randomizeShape(const RandomSettings* randomSettings, uint8_t gridX,
 			}
 		}
 	}
+	endEdit();// publish the randomized shape as a whole
 }
 
 
-bool Shape::isDirty(const Shape* refShape) {
-	if (numPts != refShape->numPts) {
-		return true;
-	}
-	for (int p = 0; p < numPts; p++) {
-		if (std::fabs(points[p].x - refShape->points[p].x) > 0.004f) {
-			return true;
-		}
-		if (std::fabs(points[p].y - refShape->points[p].y) > 0.008f) {
-			return true;
-		}
-		if (std::fabs(ctrl[p] - refShape->ctrl[p]) > 0.004f) {
-			return true;
-		}
-		if (type[p] != refShape->type[p]) {
-			return true;
+void Shape::addToDirtyHash(DirtyHash* dh) {
+	// the shape's own hash is only recalculated when it was edited since the last call
+	// x and ctrl are compared to 0.004 and y to 0.008 (grid of the rounding)
+	std::lock_guard<std::recursive_mutex> lk(editMutex);
+	if (dirtyHashEditCount != editCount) {
+		DirtyHash shapeDh;
+		shapeDh.add((int64_t)numPts);
+		for (int p = 0; p < numPts; p++) {
+			shapeDh.addRounded(points[p].x * 250.0f);
+			shapeDh.addRounded(points[p].y * 125.0f);
+			shapeDh.addRounded(ctrl[p] * 250.0f);
+			shapeDh.add((int64_t)type[p]);
 		}
+		dirtyHash = shapeDh.hash;
+		dirtyHashEditCount = editCount;
 	}
-	return false;
+	dh->add((int64_t)dirtyHash);
 }
 
 
@@ -11,19 +11,32 @@
 #include "../MindMeldModular.hpp"
 #include "Util.hpp"
 #include "RandomSettings.hpp"
+#include "DirtyHash.hpp"
+#include "ShapeTable.hpp"
+#include "Wavetable.hpp"
+#include "CurveKernel.hpp"
 
 
-static const int MAX_PTS = 270;
+struct ShapeNode {// one point with its ctrl and type, as stored in the undo history
+	Vec point;
+	float ctrl;
+	int8_t type;
+	
+	bool operator==(const ShapeNode& other) const {
+		return point.x == other.point.x && point.y == other.point.y && ctrl == other.ctrl && type == other.type;
+	}
+};
+
 
 class Shape {	
 	// Constants
 	public:
 	// static const int8_t decoupledFirstLast = 0x1;
+	static constexpr float MIN_CTRL = 7.5e-8f;
 
 	private:
 	static constexpr float SAFETY = 1e-5f;
 	static constexpr float SAFETYx5 = SAFETY * 5.0f;
-	static constexpr float MIN_CTRL = 7.5e-8f;
 	
 	// The following are invariants in the points:
 	//   * numPts >= 2;
@@ -37,11 +50,24 @@ class Shape {
 	float ctrl[MAX_PTS];// from MIN_CTRL to 1-MIN_CTRL, positive only, this is a percentage of the abs(dy) span
 	int8_t type[MAX_PTS];// 0 is smooth, 1 is s-shape
 	int numPts;
-	int pc;// point cache, index into points, has to be managed in lockstep with numPts such that 0 <= pc < (numPts - 1)
-	int pcDelta;
+	int pc = 0;// point cache, index into the segments of the process table's read slot, only used by process() such that 0 <= pc < (numPts - 1) of that slot
+	int pcDelta = 0;
 	
-	std::atomic_flag lock_shape = ATOMIC_FLAG_INIT;// blocking and mandatory for all modifications that can temporarily change invariants, non-blocking test for process() (should leave output unchanged when can't acquire lock)
-	float evalShapeForProcessRet = 0.0f;
+	std::recursive_mutex editMutex;// serializes the editing threads (UI and preset worker), mandatory for all modifications, never taken by process()
+	int editDepth = 0;// edits can be nested, only the outermost endEdit() publishes
+	uint32_t editCount = 0;// incremented by every outermost endEdit()
+	uint32_t dirtyHashEditCount = 0xFFFFFFFF;// editCount when dirtyHash was calculated
+	uint64_t dirtyHash = 0;
+	ShapeTable* processTable = nullptr;// compiled version of the shape for process(), only allocated for shapes that are played (not for history, dirty cache, etc.)
+	ShapeWavetable* wavetable = nullptr;// not owned, also given the compiled shape when set
+	
+	void compileToProcessTable();
+	
+	void writeCtrlWithSafety(int p, float newCtrl) {
+		if (p < (numPts - 1)) {
+			ctrl[p] = clamp(newCtrl, MIN_CTRL, 1.0f - MIN_CTRL);
+		}		
+	}
 	
 	
 	public:
@@ -54,16 +80,22 @@ class Shape {
 		return (rndVal - 0.5f) * _ctrlMax * 0.01f + 0.5f;
 	}	
 	
-	bool lockShapeNonBlocking() {// returns true if we got the lock successfuly
-		return !lock_shape.test_and_set();//std::memory_order_acquire);
-	}
-	
-	void lockShapeBlocking() {
-		while (lock_shape.test_and_set()) {};//std::memory_order_acquire)) {}
+	// Editing is RCU-like: the editor modifies points/ctrl/type in place, and process() only ever sees the complete 
+	//   versions that are compiled and published into the process table when the outermost edit ends 
+	void beginEdit() {
+		editMutex.lock();
+		editDepth++;
 	}
 	
-	void unlockShape() {// only call this after having called lockShapeBlocking() or after a successful lockShapeNonBlocking()
-		lock_shape.clear();//std::memory_order_release);
+	void endEdit() {// only call this after having called beginEdit()
+		editDepth--;
+		if (editDepth == 0) {
+			editCount++;
+			if (processTable) {
+				compileToProcessTable();// invariants are respected here
+			}
+		}
+		editMutex.unlock();
 	}
 	
 	
@@ -71,10 +103,32 @@ class Shape {
 		onReset(); 
 	}
 	
+	~Shape() {
+		delete processTable;
+	}
+	
+	void enableProcessTable() {
+		if (!processTable) {
+			processTable = new ShapeTable();
+			beginEdit();
+			endEdit();
+		}
+	}
+	
+	void setWavetable(ShapeWavetable* _wavetable) {// processTable must be enabled
+		beginEdit();
+		wavetable = _wavetable;
+		endEdit();
+	}
+	
 	void onReset();
 	
 	void initMinPts();
 	
+	uint32_t getEditCount() {// changes every time an edit ends, for caches of things derived from the shape
+		return editCount;
+	}
+	
 	int getPc() {
 		return pc;
 	}
@@ -113,7 +167,7 @@ class Shape {
 		}
 		
 		c *= (T)2.0;
-		T _y = _x * std::pow(c, (T)2.0 * ((T)1.0 - _x));
+		T _y = _x * curvePow(c, (T)2.0 * ((T)1.0 - _x));
 	
 		if (mirror) {
 			_y = (T)1.0 - _y;
@@ -269,36 +323,42 @@ class Shape {
 		return gp;// no longer a guess point, but the real point
 	}	
 	
-	float evalShapeForProcess(double x) {
+	const ShapeSegment* prepareEvalForProcess(double x, float* t) {
 		// should be used by process() only since it changes the local pc (if GUI uses this method, the pc will be changed)
-		// returns previous value if couldn't get lock to calc an eval
+		// uses the compiled process table, so enableProcessTable() must have been called
 		// x is in normalized space [0;1]
+		// returns the segment to evaluate at the returned *t
+		bool isNew;
+		const ShapeTableSlot* slot = processTable->getReadSlot(&isNew);
+		int slotNumPts = slot->numPts;
+		if (isNew) {
+			pc = std::min(pc, slotNumPts - 2);
+		}
 		if (x <= 0.0) {
 			pcDelta = -pc;
 			pc = 0;
-			evalShapeForProcessRet = points[0].y;
+			*t = 0.0f;
+			return &slot->segs[0];
 		}
 		else if (x >= 1.0) {
-			int newpc = numPts - 2;// is sure to be >= 0, and pc must be < numPts-1
+			int newpc = slotNumPts - 2;// is sure to be >= 0, and pc must be < numPts-1
 			pcDelta = newpc - pc;
 			pc = newpc;
-			evalShapeForProcessRet = points[numPts - 1].y;			
+			*t = 0.0f;
+			return &slot->segs[slotNumPts - 1];// last node is flat
 		}
-		else {
-			// here x is in ]0;1[
-			if (lockShapeNonBlocking()) {
-				int newpc = calcPointFromX<double>(x, pc);
-				pcDelta = newpc - pc;
-				pc = newpc;		
-				evalShapeForProcessRet = calcY<double>(pc, x - (double)points[pc].x);
-				unlockShape();
-			}
-			// else {
-				// keep pc unchanged
-				// keep evalShapeForProcessRet unchanged
-			// }
-		}	
-		return evalShapeForProcessRet;
+		// here x is in ]0;1[
+		int newpc = slot->findSegment(x, pc);
+		pcDelta = isNew ? 0 : newpc - pc;// don't want node triggers when nodes are inserted or deleted
+		pc = newpc;		
+		*t = slot->segs[pc].calcT(x);
+		return &slot->segs[pc];
+	}
+	
+	float evalShapeForProcess(double x) {
+		float t;
+		const ShapeSegment* seg = prepareEvalForProcess(x, &t);
+		return seg->evalT(t);
 	}
 	float evalShapeForDisplay(float x, int* epc) {
 		// external point cache
@@ -341,10 +401,14 @@ class Shape {
 	}
 	
 	void setPoint(int p, Vec newPt) {
+		beginEdit();
 		points[p] = newPt;
+		endEdit();
 	}
 	void coupleFirstAndLast() {
+		beginEdit();
 		points[numPts - 1].y = points[0].y;
+		endEdit();
 	}
 
 	void setPointWithSafety(int p, Vec newPt, int xQuant, int yQuant, bool decoupledFirstLast);
@@ -390,9 +454,9 @@ class Shape {
 	}
 	
 	void setCtrlWithSafety(int p, float newCtrl) {
-		if (p < (numPts - 1)) {
-			ctrl[p] = clamp(newCtrl, MIN_CTRL, 1.0f - MIN_CTRL);
-		}		
+		beginEdit();
+		writeCtrlWithSafety(p, newCtrl);
+		endEdit();
 	}
 
 	bool isCtrlVisible(int pt) {
@@ -408,15 +472,19 @@ class Shape {
 	}
 	
 	void setType(int pt, int8_t newType) {
+		beginEdit();
 		type[pt] = newType;
+		endEdit();
 	}
 
 	
 	// json
 	// ----------------
-	json_t* dataToJsonShape();
+	json_t* dataToJsonShape(bool withBinShape = false);
 	
 	void dataFromJsonShape(json_t *shapeJ);
+	
+	bool dataFromBinaryShape(const std::vector<uint8_t>& data);
 
 
 	// other
@@ -426,13 +494,29 @@ class Shape {
 
 	void pasteShapeFrom(const Shape* srcShape);
 	
+	ShapeNode getNode(int p) {
+		ShapeNode node;
+		node.point = points[p];
+		node.ctrl = ctrl[p];
+		node.type = type[p];
+		return node;
+	}
+	
+	void getNodes(ShapeNode* dest, int start, int count);
+	
+	uint64_t calcNodesHash();
+	
+	bool replaceNodes(int start, int numOld, const ShapeNode* newNodes, int numNew, uint64_t expectedHash);
+	
+	void setNodes(const ShapeNode* nodes, int num);
+	
 	void reverseShape();
 	
 	void invertShape();
 	
 	void randomizeShape(const RandomSettings* randomSettings, uint8_t gridX, int8_t rangeIndex, bool decoupledFirstLast);
 	
-	bool isDirty(const Shape* refShape);
+	void addToDirtyHash(DirtyHash* dh);
 };
 
 
@@ -77,6 +77,9 @@ ShapeMaster::ShapeMaster() {// : worker(&ShapeMaster::worker_nextPresetOrShape,
 	
 	for (int c = 0; c < 8; c++) {
 		channels[c].construct(c, &running, &sosEosEoc, &clockDetector, &inputs[0], &outputs[0], &params[0], &paramQuantities, &presetAndShapeManager);
+		channels[c].getShape()->enableProcessTable();
+		channels[c].enableWavetable(wavetableRenderer.getWavetable(c));
+		channels[c].enableSidechainEngine(&sidechainEngine);
 	}
 	presetAndShapeManager.construct(channels, &channelDirtyCache, &miscSettings3);
 	channelDirtyCache.construct(0, &running, NULL, NULL, &inputs[0], &outputs[0], channelDirtyCacheParams, NULL, NULL);
@@ -100,12 +103,14 @@ void ShapeMaster::onReset() {
 	miscSettings3.cc4[0] = 0x0;// preset EOC deferral
 	miscSettings3.cc4[1] = 0x0;// shape EOC deferral
 	miscSettings3.cc4[2] = 0x0;// cloaked mode
-	miscSettings3.cc4[3] = 0x0;// unused
+	miscSettings3.cc4[3] = 0x0;// compact shapes in patch (not readable by 2.5.0 and earlier)
 	lineWidth = 1.0f;
+	scopeResIndex = 1;
 	for (int c = 0; c < NUM_CHAN; c++) {
 		channels[c].onReset(false);
 	}
 	channelDirtyCache.onReset(true);
+	presetAndShapeManager.invalidateDirtyRef();
 	currChan = 0;
 	resetNonJson();
 }
@@ -133,10 +138,13 @@ json_t* ShapeMaster::dataToJson() {
 	// lineWidth
 	json_object_set_new(rootJ, "lineWidth", json_real(lineWidth));
 
+	// scopeResIndex
+	json_object_set_new(rootJ, "scopeResIndex", json_integer(scopeResIndex));
+
 	// channels
 	json_t* channelsJ = json_array();
 	for (size_t c = 0; c < 8; c++) {
-		json_t* channelJ = channels[c].dataToJsonChannel(WITHOUT_PARAMS, WITH_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS);
+		json_t* channelJ = channels[c].dataToJsonChannel(WITHOUT_PARAMS, WITH_PRO_UNSYNC_MATCH, WITH_FULL_SETTINGS, miscSettings3.cc4[3] != 0);
 		json_array_insert_new(channelsJ, c , channelJ);
 	}
 	json_object_set_new(rootJ, "channels", channelsJ);
@@ -173,6 +181,10 @@ void ShapeMaster::dataFromJson(json_t *rootJ) {
 	json_t *lineWidthJ = json_object_get(rootJ, "lineWidth");
 	if (lineWidthJ) lineWidth = json_number_value(lineWidthJ);
 
+	// scopeResIndex
+	json_t *scopeResIndexJ = json_object_get(rootJ, "scopeResIndex");
+	if (scopeResIndexJ) scopeResIndex = clamp((int)json_integer_value(scopeResIndexJ), 0, NUM_SCOPE_RES - 1);
+
 	// channels
 	json_t* channelsJ = json_object_get(rootJ, "channels");
 	if (channelsJ && json_is_array(channelsJ)) {
@@ -234,13 +246,16 @@ void ShapeMaster::process(const ProcessArgs &args) {
 	}
 	
 	// Clock (with no -1 allowed in ClockDetector::clockCount
-	bool clockRisingEdge = clockTrigger.process(inputs[CLOCK_INPUT].getVoltage());
+	float clockVoltage = inputs[CLOCK_INPUT].getVoltage();
+	bool clockRisingEdge = clockTrigger.process(clockVoltage);
+	float clockEdgeFrac = clockRisingEdge ? ClockDetector::calcEdgeFrac(lastClockVoltage, clockVoltage) : 0.0f;
+	lastClockVoltage = clockVoltage;
 	if (clockIgnoreOnReset != 0) {
 		clockRisingEdge = false;
 		
 	}
 	if (running) {
-		clockDetector.process(clockRisingEdge);
+		clockDetector.process(clockRisingEdge, clockEdgeFrac);
 	}
 	
 
@@ -257,12 +272,22 @@ void ShapeMaster::process(const ProcessArgs &args) {
 	}	
 
 	// Main process
+	bool needsEval[NUM_CHAN];
+	float shapeCvs[NUM_CHAN];
 	for (int c = 0; c < NUM_CHAN; c++) {
-		channels[c].process(c == fsDiv8, cvExp ? &(cvExp->chanCvs[c]) : NULL);
+		needsEval[c] = channels[c].processHead(c == fsDiv8, cvExp ? &(cvExp->chanCvs[c]) : NULL);
+	}
+	Channel::evalShapesForProcess(channels, needsEval, shapeCvs);
+	for (int c = 0; c < NUM_CHAN; c++) {
+		channels[c].processVcaIn();
+	}
+	sidechainEngine.process(args.sampleTime);
+	for (int c = 0; c < NUM_CHAN; c++) {
+		channels[c].processTail(shapeCvs[c]);
 	}
 	
 	// Scope
-	scopeBuffers.populate(&channels[currChan], miscSettings.cc4[2]);
+	scopeEngine.capture(channels, currChan, miscSettings.cc4[2], scopeResIndex);
 	
 	// Lights (others are in module widget's step())
 	if (refresh.processLights()) {
@@ -331,6 +356,12 @@ void ShapeMasterWidget::appendContextMenu(Menu *menu) {
 	runOffSetItem->srcRunOffSetting = &(module->miscSettings2.cc4[1]);
 	menu->addChild(runOffSetItem);
 
+	menu->addChild(createCheckMenuItem("Compact shapes in patch", "",
+		[=]() {return module->miscSettings3.cc4[3] != 0;},
+		[=]() {module->miscSettings3.cc4[3] ^= 0x1;}
+	));
+	menu->addChild(createMenuLabel("(faster loading, needs ShapeMaster 2.5.1 or later)"));
+
 
 	menu->addChild(new MenuSeparator());
 
@@ -349,6 +380,21 @@ void ShapeMasterWidget::appendContextMenu(Menu *menu) {
 		[=]() {module->miscSettings.cc4[3] ^= 0x1;}
 	));
 	
+	menu->addChild(createCheckMenuItem("Scope shows all channels", "",
+		[=]() {return (module->miscSettings.cc4[2] & SCOPE_MASK_OVERLAY) != 0;},
+		[=]() {module->miscSettings.cc4[2] ^= SCOPE_MASK_OVERLAY;}
+	));
+	
+	menu->addChild(createSubmenuItem("Scope resolution", "", [=](Menu* menu) {
+		const std::string resNames[NUM_SCOPE_RES] = {"Low", "Normal (default)", "High", "Very high"};
+		for (int i = 0; i < NUM_SCOPE_RES; i++) {
+			menu->addChild(createCheckMenuItem(resNames[i], "",
+				[=]() {return module->scopeResIndex == i;},
+				[=]() {module->scopeResIndex = i;}
+			));
+		}
+	}));
+	
 	LineWidthSlider *lineWidthSlider = new LineWidthSlider(&module->lineWidth);
 	lineWidthSlider->box.size.x = 200.0f;
 	menu->addChild(lineWidthSlider);
@@ -480,7 +526,7 @@ ShapeMasterWidget::ShapeMasterWidget(ShapeMaster *module) {
 		scopeButtons->settingSrc = &module->miscSettings.cc4[2];
 		scopeButtons->currChan = &(module->currChan);
 		scopeButtons->channels = module->channels;
-		scopeButtons->scopeBuffers = &(module->scopeBuffers);
+		scopeButtons->scopeEngine = &(module->scopeEngine);
 		shapeButtons->currChan = &(module->currChan);
 		shapeButtons->channels = module->channels;
 	}
@@ -506,7 +552,7 @@ ShapeMasterWidget::ShapeMasterWidget(ShapeMaster *module) {
 		smDisplayLight->setting2Src = &(module->miscSettings2);
 		smDisplayLight->setting3Src = &(module->miscSettings3);
 		smDisplayLight->lineWidthSrc = &(module->lineWidth);
-		smDisplayLight->scopeBuffers = &(module->scopeBuffers);
+		smDisplayLight->scopeEngine = &(module->scopeEngine);
 	}
 
 	// Screen - Big Numbers
@@ -807,26 +853,22 @@ void ShapeMasterWidget::step() {
 		if ((stepDivider & 0x7) == 0) {
 			std::string currChanPresetPath = module->channels[chan].getPresetPath();
 			std::string currChanShapePath = module->channels[chan].getShapePath();
-			if (!currChanPresetPath.empty()) {
-				if (!(module->channelDirtyCache.getPresetPath() == currChanPresetPath)) {
-					if (!loadPresetOrShape(currChanPresetPath, &module->channelDirtyCache, true, &unsupportedSync, false)) {
-						currChanPresetPath = "";
-						module->channels[chan].setPresetPath(currChanPresetPath);
+			if (!currChanPresetPath.empty() || !currChanShapePath.empty()) {
+				// reference file is loaded and hashed by the preset and shape manager's worker, the dirty state is held until it's ready
+				bool isPreset = !currChanPresetPath.empty();
+				uint64_t refHash;
+				int refState = module->presetAndShapeManager.getDirtyRef(isPreset ? currChanPresetPath : currChanShapePath, isPreset, &refHash, &unsupportedSync);
+				if (refState == DRS_FAILED) {
+					if (isPreset) {
+						module->channels[chan].setPresetPath("");
 					}
+					else {
+						module->channels[chan].setShapePath("");
+					}
+					presetOrShapeDirty = false;
 				}
-				if (!currChanPresetPath.empty()) {
-					presetOrShapeDirty = module->channels[chan].isDirty(&module->channelDirtyCache);
-				}
-			}
-			else if (!currChanShapePath.empty()) {
-				if (!(module->channelDirtyCache.getShapePath() == currChanShapePath)) {
-					if (!loadPresetOrShape(currChanShapePath, &module->channelDirtyCache, false, NULL, false)) {
-						currChanShapePath = "";
-						module->channels[chan].setShapePath(currChanShapePath);
-					}	
-				}
-				if (!currChanShapePath.empty()) {
-					presetOrShapeDirty = module->channels[chan].isDirtyShape(&module->channelDirtyCache);
+				else if (refState == DRS_READY) {
+					presetOrShapeDirty = (isPreset ? module->channels[chan].calcDirtyHash() : module->channels[chan].calcDirtyHashShape()) != refHash;
 				}
 			}
 			else {
@@ -834,6 +876,9 @@ void ShapeMasterWidget::step() {
 			}
 		}
 		
+		// Batch processing result (batch is run in its own thread)
+		module->presetAndShapeManager.showBatchResultIfDone();
+		
 		// Borders	
 		int newSizeAdd = 0;
 		if (module->expPresentLeft) {
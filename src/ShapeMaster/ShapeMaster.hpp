@@ -58,11 +58,12 @@ struct ShapeMaster : Module {
 	float lineWidth = 0.0f;
 	Channel channels[8];
 	int currChan = 0;
+	int8_t scopeResIndex = 1;
 
 
 	// No need to save, with reset
 	long clockIgnoreOnReset = 0;
-	ScopeBuffers scopeBuffers;
+	ScopeEngine scopeEngine;
 	
 	// No need to save, no reset
 	RefreshCounter refresh;
@@ -74,8 +75,11 @@ struct ShapeMaster : Module {
 	uint32_t sosEosEoc = 0;// always set up in this.process(), and channel/playhead should only use in process() scope
 	dsp::SchmittTrigger runTrigger;
 	dsp::SchmittTrigger clockTrigger;
+	float lastClockVoltage = 0.0f;// for the sub-sample timing of clock edges
 	dsp::SchmittTrigger resetTrigger;
 	PresetAndShapeManager presetAndShapeManager;
+	WavetableRenderer wavetableRenderer;// must be declared after channels, so that its worker is stopped first
+	SidechainEngine sidechainEngine;
 	Channel channelDirtyCache;
 	Param channelDirtyCacheParams[NUM_CHAN_PARAMS] = {};
 
@@ -94,7 +98,7 @@ struct ShapeMaster : Module {
 	
 	void resetNonJson() {
 		clockIgnoreOnReset = (long) (0.001f * APP->engine->getSampleRate());
-		scopeBuffers.reset();
+		scopeEngine.reset();
 	}
 
 
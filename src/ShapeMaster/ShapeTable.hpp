@@ -0,0 +1,186 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include "rack.hpp"
+#include "CurveKernel.hpp"
+
+using namespace rack;
+
+
+static const int MAX_PTS = 270;
+
+
+// A shape compiled for process(): one segment per node (except the last node), with everything that
+//   does not depend on x precalculated, so that an eval is a search and one exp2() at most
+struct ShapeSegment {
+	enum SegModes {SEG_FLAT, SEG_LINEAR, SEG_SMOOTH, SEG_SMOOTH_MIRROR, SEG_SCURVE};
+
+	float x0;// x of the left node
+	float invDx;// 1 / dx
+	float y0;// y of the left node
+	float dy;
+	float k;// SEG_SMOOTH(_MIRROR): 2*log2(2c) with c already mirrored; SEG_SCURVE: k of the sigmoid; 0.0f otherwise
+	int8_t mode;
+
+	float calcT(double x) const {
+		// x is in normalized space and must be >= x0
+		// returns the normalized position within the segment, 0.0f for SEG_FLAT
+		return std::fmin((float)((x - (double)x0) * (double)invDx), 1.0f);
+	}
+
+	float evalT(float t) const {
+		float y;
+		if (mode == SEG_FLAT) {
+			return y0;
+		}
+		else if (mode == SEG_LINEAR) {
+			y = t;
+		}
+		else if (mode == SEG_SMOOTH) {
+			y = t * fastExp2(k * (1.0f - t));// same as t * (2c)^(2(1-t))
+		}
+		else if (mode == SEG_SMOOTH_MIRROR) {
+			float u = 1.0f - t;
+			y = 1.0f - u * fastExp2(k * t);
+		}
+		else {// SEG_SCURVE
+			float u = t - 0.5f;
+			y = (u * (1.0f - k)) / (k - 4.0f * k * std::fabs(u) + 1.0f) + 0.5f;
+		}
+		return y0 + y * dy;
+	}
+
+	float eval(double x) const {
+		return evalT(calcT(x));
+	}
+	
+	static simd::float_4 evalSimd(const ShapeSegment* const* segs, simd::float_4 t) {
+		// four segments (that can be from different shapes) evaluated at once, SEG_LINEAR and SEG_FLAT are 
+		//   done as SEG_SMOOTH since their k is 0.0f (and t is 0.0f for SEG_FLAT)
+		simd::float_4 y0, dy, k, mirror, scurve;
+		for (int i = 0; i < 4; i++) {
+			y0[i] = segs[i]->y0;
+			dy[i] = segs[i]->dy;
+			k[i] = segs[i]->k;
+			mirror[i] = segs[i]->mode == SEG_SMOOTH_MIRROR ? 1.0f : 0.0f;
+			scurve[i] = segs[i]->mode == SEG_SCURVE ? 1.0f : 0.0f;
+		}
+		simd::float_4 isMirror = mirror != 0.0f;
+		simd::float_4 u = simd::ifelse(isMirror, 1.0f - t, t);
+		simd::float_4 ys = u * fastExp2(k * (1.0f - u));
+		ys = simd::ifelse(isMirror, 1.0f - ys, ys);
+		simd::float_4 v = t - 0.5f;
+		simd::float_4 ysc = (v * (1.0f - k)) / (k - 4.0f * k * simd::fabs(v) + 1.0f) + 0.5f;
+		return y0 + simd::ifelse(scurve != 0.0f, ysc, ys) * dy;
+	}
+};
+
+
+struct ShapeTableSlot {
+	static const int NUM_BUCKETS = 512;
+
+	ShapeSegment segs[MAX_PTS];// segs[numPts - 1] is only used for its x0 (always 1.0f) and y0
+	int numPts = 0;
+	int16_t bucketSegs[NUM_BUCKETS + 1] = {};// x-index, bucketSegs[b] is the last segment that starts at or before b / NUM_BUCKETS
+
+	void buildIndex() {
+		// must be called once segs and numPts are set, O(numPts + NUM_BUCKETS)
+		int p = 0;
+		for (int b = 0; b <= NUM_BUCKETS; b++) {
+			double edge = (double)b / (double)NUM_BUCKETS;// exact in float and double
+			while (p < numPts - 2 && (double)segs[p + 1].x0 <= edge) {
+				p++;
+			}
+			bucketSegs[b] = (int16_t)p;
+		}
+	}
+
+	void copyFrom(const ShapeTableSlot* src) {
+		std::memcpy(segs, src->segs, sizeof(ShapeSegment) * src->numPts);
+		std::memcpy(bucketSegs, src->bucketSegs, sizeof(bucketSegs));
+		numPts = src->numPts;
+	}
+
+	int findSegment(double x, int gp) const {
+		// check guess point and its neighbours (playhead moving normally), then look up the x-index, where only the
+		//   segments that start inside x's bucket remain to be searched (none or one unless nodes are very close together)
+		// assumes: 0.0 < x < 1.0
+		// assumes: 0 <= gp < (numPts - 1)
+		if (x >= segs[gp].x0) {
+			if (x < segs[gp + 1].x0) {
+				return gp;
+			}
+			gp++;
+			if (x < segs[gp + 1].x0) {
+				return gp;
+			}
+		}
+		else if (gp > 0 && x >= segs[gp - 1].x0) {
+			return gp - 1;
+		}
+		int b = (int)(x * (double)NUM_BUCKETS);
+		return bisect(x, bucketSegs[b], bucketSegs[b + 1]);
+	}
+
+	int bisect(double x, int low, int high) const {
+		// returns the last segment in [low:high] that has its x0 <= x (low when none)
+		while (low < high) {
+			int mid = (low + high + 1) >> 1;
+			if (x >= segs[mid].x0) {
+				low = mid;
+			}
+			else {
+				high = mid - 1;
+			}
+		}
+		return low;
+	}
+};
+
+
+// Hand-off of data from one writer thread at a time to the audio thread (compiled shapes, rendered wavetables)
+// Three slots are used so that the writer never touches the slot being read: the writer owns one slot,
+//   the reader owns another, and the last one is exchanged atomically (with a fresh flag) when publishing or picking up
+template<typename SLOT>
+class TripleSlot {
+	static const int FRESH = 0x4;
+
+	SLOT slots[3];
+	std::atomic<int> middle;
+	int back = 0;// only used by writer
+	int front = 1;// only used by reader
+
+
+	public:
+
+	TripleSlot() {
+		middle.store(2);
+	}
+
+	SLOT* getWriteSlot() {
+		return &slots[back];
+	}
+
+	void publish() {
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+	}
+
+	const SLOT* getReadSlot(bool* isNew) {
+		*isNew = (middle.load(std::memory_order_relaxed) & FRESH) != 0;
+		if (*isNew) {
+			front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+		}
+		return &slots[front];
+	}
+};
+
+
+// compiled shapes, written by the editing threads (UI and preset worker)
+typedef TripleSlot<ShapeTableSlot> ShapeTable;
@@ -0,0 +1,234 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include "rack.hpp"
+
+using namespace rack;
+
+
+// Sidechain analysis of the 8 channels, 4 channels per float_4:
+//   HPF and LPF (4th order Butterworth, as two cascaded biquads each), optional RMS detector, then envelope slew
+// Each channel sets its own lane's coefficients, and an inactive filter is a wire (b0 = 1)
+class SidechainEngine {
+	struct Biquads {
+		simd::float_4 b[2][3];// [section][coefficient], one channel per lane
+		simd::float_4 a[2][3 - 1];
+		simd::float_4 x[2][3 - 1];
+		simd::float_4 y[2][3 - 1];
+	};
+
+	Biquads hpf[2];// [group]
+	Biquads lpf[2];
+	simd::float_4 rmsCoef[2];// 0.0f for lanes that are not in RMS mode
+	simd::float_4 meanSquare[2];
+	simd::float_4 envRise[2];
+	simd::float_4 envFall[2];
+	simd::float_4 envelope[2];
+
+	// io, per channel
+	float scIns[8] = {};
+	float scOuts[8] = {};
+	bool needsProcessing[8] = {};
+
+
+	static void setLane(Biquads* bq, int lane, bool isHighPass, bool active, float nfc) {
+		for (int s = 0; s < 2; s++) {
+			if (!active) {
+				bq->b[s][0][lane] = 1.0f;
+				bq->b[s][1][lane] = 0.0f;
+				bq->b[s][2][lane] = 0.0f;
+				bq->a[s][0][lane] = 0.0f;
+				bq->a[s][1][lane] = 0.0f;
+				continue;
+			}
+			// same as ButterworthSecondOrder::setParameters()
+			float nfcw = nfc < 0.025f ? float(M_PI) * nfc : std::tan(float(M_PI) * std::min(0.499f, nfc));
+			float midCoef = s == 0 ? 0.765367f : 1.847759f;// see ButterworthFourthOrder
+			float acst = nfcw * nfcw + nfcw * midCoef + 1.0f;
+			bq->a[s][0][lane] = 2.0f * (nfcw * nfcw - 1.0f) / acst;
+			bq->a[s][1][lane] = (nfcw * nfcw - nfcw * midCoef + 1.0f) / acst;
+			float hbcst = 1.0f / acst;
+			float lbcst = hbcst * nfcw * nfcw;
+			bq->b[s][0][lane] = isHighPass ? hbcst : lbcst;
+			bq->b[s][1][lane] = (isHighPass ? -hbcst : lbcst) * 2.0f;
+			bq->b[s][2][lane] = bq->b[s][0][lane];
+		}
+	}
+
+	static simd::float_4 processBiquads(Biquads* bq, simd::float_4 in, simd::float_4 doUpdate) {
+		// states are only updated in the lanes of doUpdate, like the scalar filters that were not run when not needed
+		for (int s = 0; s < 2; s++) {
+			simd::float_4 out = bq->b[s][0] * in + bq->b[s][1] * bq->x[s][0] + bq->b[s][2] * bq->x[s][1] - bq->a[s][0] * bq->y[s][0] - bq->a[s][1] * bq->y[s][1];
+			bq->x[s][1] = simd::ifelse(doUpdate, bq->x[s][0], bq->x[s][1]);
+			bq->x[s][0] = simd::ifelse(doUpdate, in, bq->x[s][0]);
+			bq->y[s][1] = simd::ifelse(doUpdate, bq->y[s][0], bq->y[s][1]);
+			bq->y[s][0] = simd::ifelse(doUpdate, out, bq->y[s][0]);
+			in = out;
+		}
+		return in;
+	}
+
+
+	public:
+
+	SidechainEngine() {
+		for (int g = 0; g < 2; g++) {
+			rmsCoef[g] = 0.0f;
+			envRise[g] = 0.0f;
+			envFall[g] = 0.0f;
+			for (int l = 0; l < 4; l++) {
+				setLane(&hpf[g], l, true, false, 0.1f);
+				setLane(&lpf[g], l, false, false, 0.4f);
+			}
+		}
+		for (int c = 0; c < 8; c++) {
+			reset(c);
+		}
+	}
+
+	void reset(int c) {
+		int g = c >> 2;
+		int l = c & 0x3;
+		for (int s = 0; s < 2; s++) {
+			for (int i = 0; i < 2; i++) {
+				hpf[g].x[s][i][l] = 0.0f;
+				hpf[g].y[s][i][l] = 0.0f;
+				lpf[g].x[s][i][l] = 0.0f;
+				lpf[g].y[s][i][l] = 0.0f;
+			}
+		}
+		meanSquare[g][l] = 0.0f;
+		envelope[g][l] = 0.0f;
+		scOuts[c] = 0.0f;
+	}
+
+
+	// Setters (channel c)
+	// --------
+
+	void setHpf(int c, bool active, float nfc) {
+		setLane(&hpf[c >> 2], c & 0x3, true, active, nfc);
+	}
+	void setLpf(int c, bool active, float nfc) {
+		setLane(&lpf[c >> 2], c & 0x3, false, active, nfc);
+	}
+	void setEnvelopeRiseFall(int c, float rise, float fall) {
+		envRise[c >> 2][c & 0x3] = rise;
+		envFall[c >> 2][c & 0x3] = fall;
+	}
+	void setRms(int c, float windowTime, float sampleTime) {
+		// windowTime <= 0.0f turns off the RMS detector (the envelope follows the filtered signal, as before)
+		rmsCoef[c >> 2][c & 0x3] = windowTime > 0.0f ? (1.0f - std::exp(-sampleTime / windowTime)) : 0.0f;
+	}
+
+
+	// Process
+	// --------
+
+	void setInput(int c, float scIn) {
+		// only call for channels that need sidechain processing this sample
+		scIns[c] = scIn;
+		needsProcessing[c] = true;
+	}
+	float getSignal(int c) {
+		return scOuts[c];
+	}
+	float getEnvelope(int c) {
+		return envelope[c >> 2][c & 0x3];
+	}
+
+	void process(float deltaTime) {
+		for (int g = 0; g < 2; g++) {
+			int c0 = g << 2;
+			if (!(needsProcessing[c0] || needsProcessing[c0 + 1] || needsProcessing[c0 + 2] || needsProcessing[c0 + 3])) {
+				continue;
+			}
+			simd::float_4 doUpdate = simd::float_4(needsProcessing[c0], needsProcessing[c0 + 1], needsProcessing[c0 + 2], needsProcessing[c0 + 3]) != 0.0f;
+			simd::float_4 sig = simd::float_4::load(&scIns[c0]);
+			sig = processBiquads(&hpf[g], sig, doUpdate);
+			sig = processBiquads(&lpf[g], sig, doUpdate);
+			sig.store(&scOuts[c0]);
+
+			// detector
+			simd::float_4 isRms = rmsCoef[g] != 0.0f;
+			if (simd::movemask(isRms) != 0) {
+				simd::float_4 newMs = meanSquare[g] + rmsCoef[g] * (sig * sig - meanSquare[g]);
+				meanSquare[g] = simd::ifelse(doUpdate, newMs, meanSquare[g]);
+				sig = simd::ifelse(isRms, simd::sqrt(meanSquare[g]), sig);
+			}
+
+			// envelope slew, same as dsp::SlewLimiter
+			simd::float_4 newEnv = simd::clamp(sig, envelope[g] - envFall[g] * deltaTime, envelope[g] + envRise[g] * deltaTime);
+			envelope[g] = simd::ifelse(doUpdate, newEnv, envelope[g]);
+
+			for (int l = 0; l < 4; l++) {
+				needsProcessing[c0 + l] = false;
+			}
+		}
+	}
+};
+
+
+// Delay of the (up to 16 channel) VCA input when the sidechain looks ahead, so that the envelope
+//   can react before the audio it is applied to
+// The delay line is sized for the longest look-ahead at the current sample rate, and is cleared whenever it 
+//   resumes after a pause or its delay or number of channels changes, so that stale audio is never replayed
+class PolyLookAhead {
+	std::vector<float> buf;// [size][16]
+	int size = 0;
+	int head = 0;
+	int lastDelay = -1;
+	int lastNumChans = -1;
+	bool stopped = true;
+
+
+	public:
+
+	void setMaxDelay(float maxDelayTime, double sampleTime) {
+		// not called by the audio thread while it processes (Module::onSampleRateChange())
+		int newSize = (int)((double)maxDelayTime / sampleTime + 0.5) + 1;
+		if (newSize != size) {
+			size = newSize;
+			buf.assign(size * 16, 0.0f);
+			head = 0;
+			stopped = true;
+		}
+	}
+
+	int calcDelay(float delayTime, double sampleTime) const {
+		return std::max(0, std::min((int)((double)delayTime / sampleTime + 0.5), size - 1));
+	}
+
+	void stop() {
+		// call when process() is not called for a sample
+		stopped = true;
+	}
+
+	void process(float* vca, int numChans, int delay) {
+		// vca is replaced by its version from delay samples ago
+		if (size == 0) {
+			return;
+		}
+		if (stopped || delay != lastDelay || numChans != lastNumChans) {
+			std::fill(buf.begin(), buf.end(), 0.0f);
+			head = 0;
+			lastDelay = delay;
+			lastNumChans = numChans;
+			stopped = false;
+		}
+		std::memcpy(&buf[head * 16], vca, sizeof(float) * numChans);
+		int tail = head - delay;
+		if (tail < 0) {
+			tail += size;
+		}
+		std::memcpy(vca, &buf[tail * 16], sizeof(float) * numChans);
+		head = (head + 1) % size;
+	}
+};
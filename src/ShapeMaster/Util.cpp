@@ -61,8 +61,8 @@ MutlDivRatio multDivTable[NUM_RATIOS] = { // should calc for even number of shap
 // Trig mode and play mode
 // --------
 
-std::string trigModeNames[NUM_TRIG_MODES] = {"AUTO", "T/G", "CTRL", "SC", "CV"};
-std::string trigModeNamesLong[NUM_TRIG_MODES] = {"Automatic", "Trigger/Gate", "Gate control", "Sidechain", "CV playhead (uses T/G in)"};
+std::string trigModeNames[NUM_TRIG_MODES] = {"AUTO", "T/G", "CTRL", "SC", "CV", "OSC"};
+std::string trigModeNamesLong[NUM_TRIG_MODES] = {"Automatic", "Trigger/Gate", "Gate control", "Sidechain", "CV playhead (uses T/G in)", "Oscillator (V/oct on T/G in)"};
 
 std::string playModeNames[NUM_PLAY_MODES] = {"FWD", "REV", "PNG"};
 std::string playModeNamesLong[NUM_PLAY_MODES] = {"Forward", "Reverse", "PingPong"};
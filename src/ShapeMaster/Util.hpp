@@ -275,7 +275,7 @@ inline float unsuncedLengthParamToVoct(float p) {
 // Trig mode and play mode
 // --------
 
-enum TridModeIds {TM_AUTO, TM_TRIG_GATE, TM_GATE_CTRL, TM_SC, TM_CV, NUM_TRIG_MODES};
+enum TridModeIds {TM_AUTO, TM_TRIG_GATE, TM_GATE_CTRL, TM_SC, TM_CV, TM_OSC, NUM_TRIG_MODES};
 extern std::string trigModeNames[NUM_TRIG_MODES];
 extern std::string trigModeNamesLong[NUM_TRIG_MODES];
 
@@ -311,6 +311,30 @@ static const int polyModeChanOut[NUM_POLY_MODES] = {16, 2, 1};
 extern std::string polyModeNames[NUM_POLY_MODES];
 
 
+// Sidechain detector and look-ahead
+// --------
+
+enum ScDetectorIds {SCD_PEAK, SCD_RMS, NUM_SC_DETECTORS};
+static const int NUM_SC_RMS_WINDOWS = 4;
+static const float scRmsWindows[NUM_SC_RMS_WINDOWS] = {0.010f, 0.025f, 0.050f, 0.100f};// in seconds
+static const int NUM_SC_LOOKAHEADS = 4;
+static const float scLookAheadTimes[NUM_SC_LOOKAHEADS] = {0.0f, 0.001f, 0.002f, 0.005f};// in seconds, 0.0f is off
+
+
+// Control rate
+// --------
+
+static const int NUM_CTRL_RATES = 4;
+static const int ctrlRateDivs[NUM_CTRL_RATES] = {1, 8, 16, 32};// shape is evaluated at fs / ctrlRateDivs[], 1 is audio rate
+
+
+// Scope
+// --------
+
+static const int NUM_SCOPE_RES = 4;
+static const int scopeResPts[NUM_SCOPE_RES] = {383, 767, 1535, 3071};// number of segments in the scope traces, 767 is the original resolution
+
+
 // Other
 // --------
 
@@ -326,3 +350,6 @@ static const bool WITHOUT_PRO_UNSYNC_MATCH = false;
 static const bool WITH_FULL_SETTINGS = true;
 static const bool WITHOUT_FULL_SETTINGS = false;
 
+static const bool WITH_BIN_SHAPE = true;// compact shape that 2.5.0 and earlier can't read, only for the undo history and when asked for in patches
+static const bool WITHOUT_BIN_SHAPE = false;
+
@@ -0,0 +1,125 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#include "Wavetable.hpp"
+
+
+// ----------------------------------------------------------------------------
+// ShapeWavetable
+// ----------------------------------------------------------------------------
+
+void ShapeWavetable::setSource(const ShapeTableSlot* slot) {
+	// called by Shape::compileToProcessTable(), so at the end of every outermost edit
+	std::lock_guard<std::mutex> lk(sourceMutex);
+	source.copyFrom(slot);
+	sourceDirty.store(true);
+	if (renderer && active.load()) {
+		renderer->notify();
+	}
+}
+
+
+void ShapeWavetable::setActive(bool _active) {
+	if (_active != active.load()) {
+		active.store(_active);
+		if (_active && renderer) {
+			renderer->notify();
+		}
+	}
+}
+
+
+void ShapeWavetable::startRenderer() {
+	if (renderer) {
+		renderer->start();
+	}
+}
+
+
+void ShapeWavetable::copySource(ShapeTableSlot* dest) {
+	std::lock_guard<std::mutex> lk(sourceMutex);
+	dest->copyFrom(&source);
+	sourceDirty.store(false);
+}
+
+
+// ----------------------------------------------------------------------------
+// WavetableRenderer
+// ----------------------------------------------------------------------------
+
+WavetableRenderer::WavetableRenderer() : renderFft(RENDER_SIZE), tableFft(WavetableMips::TABLE_SIZE) {
+	context = contextGet();
+	for (int c = 0; c < 8; c++) {
+		wavetables[c].setRenderer(this);
+	}
+}
+
+
+void WavetableRenderer::start() {
+	// not called by the audio thread, and does nothing once the worker runs
+	std::lock_guard<std::mutex> lk(startMtx);
+	if (!worker.joinable()) {
+		worker = std::thread(&WavetableRenderer::render_worker, this);
+		signal.notify();// for the channels that were already active
+	}
+}
+
+
+void WavetableRenderer::render_worker() {
+	contextSet(context);
+	while (signal.wait()) {
+		// a source that changes during a render notifies again, so it's rendered in the next round
+		for (int c = 0; c < 8; c++) {
+			if (wavetables[c].needsRender()) {
+				render(&wavetables[c]);
+			}
+		}
+	}
+}
+
+
+void WavetableRenderer::render(ShapeWavetable* wavetable) {
+	wavetable->copySource(&source);
+	if (source.numPts < 2) {
+		return;
+	}
+
+	// sample the compiled shape, one period
+	int gp = 0;
+	renderBuf[0] = source.segs[0].eval(0.0);
+	for (int i = 1; i < RENDER_SIZE; i++) {
+		double x = (double)i / (double)RENDER_SIZE;
+		gp = source.findSegment(x, gp);
+		renderBuf[i] = source.segs[gp].eval(x);
+	}
+	renderFft.rfft(renderBuf, spectrum);
+
+	// band-limit each level by zeroing its upper harmonics, and resynthesize at TABLE_SIZE
+	// ordered format of the spectrum: [0] = DC, [1] = Nyquist, then the real and imaginary parts of each harmonic
+	// since the inverse FFT is not normalized, the scaling is 1 / RENDER_SIZE (the spectrum is truncated, not resampled)
+	const int numBins = WavetableMips::TABLE_SIZE / 2;
+	const float scale = 1.0f / (float)RENDER_SIZE;
+	WavetableMips* dest = wavetable->getWriteSlot();
+	for (int l = 0; l < WavetableMips::NUM_LEVELS; l++) {
+		int numHarm = numBins >> l;
+		levelSpectrum[0] = spectrum[0];
+		levelSpectrum[1] = 0.0f;
+		for (int k = 1; k < numBins; k++) {
+			bool keep = k < numHarm;
+			levelSpectrum[2 * k] = keep ? spectrum[2 * k] : 0.0f;
+			levelSpectrum[2 * k + 1] = keep ? spectrum[2 * k + 1] : 0.0f;
+		}
+		tableFft.irfft(levelSpectrum, levelBuf);
+		for (int i = 0; i < WavetableMips::TABLE_SIZE; i++) {
+			dest->samples[l][i] = levelBuf[i] * scale;
+		}
+		dest->samples[l][WavetableMips::TABLE_SIZE] = dest->samples[l][0];
+	}
+	dest->valid = true;
+	wavetable->publish();
+}
@@ -0,0 +1,148 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include <thread>
+#include "ShapeTable.hpp"
+#include "WorkSignal.hpp"
+#include "CurveKernel.hpp"
+
+
+class WavetableRenderer;
+
+
+// Band-limited and mip-mapped rendering of a shape, for the oscillator trig mode (TM_OSC)
+struct WavetableMips {
+	static const int TABLE_SIZE = 1024;
+	static const int NUM_LEVELS = 10;// level l has the harmonics below (TABLE_SIZE / 2) >> l, so the last level is DC only
+
+	float samples[NUM_LEVELS][TABLE_SIZE + 1];// the extra sample is a copy of the first one, for the interpolation
+	bool valid = false;
+};
+
+
+// One per played channel: the editing threads give it the compiled shape, the WavetableRenderer renders it in
+//   the background when the channel is in oscillator mode, and process() plays it in the audio thread
+class ShapeWavetable {
+	TripleSlot<WavetableMips> mips;
+	ShapeTableSlot source;// latest compiled shape, guarded by sourceMutex
+	std::mutex sourceMutex;
+	std::atomic<bool> sourceDirty;
+	std::atomic<bool> active;
+	WavetableRenderer* renderer = nullptr;
+
+
+	public:
+
+	ShapeWavetable() {
+		sourceDirty.store(false);
+		active.store(false);
+	}
+
+	void setRenderer(WavetableRenderer* _renderer) {
+		renderer = _renderer;
+	}
+
+	// non-audio threads that put the channel in oscillator mode
+	void startRenderer();
+
+	// editing threads
+	void setSource(const ShapeTableSlot* slot);
+
+	// audio thread (ok to call every processSlow(), only acts on changes)
+	void setActive(bool _active);
+
+	// renderer thread
+	bool needsRender() {
+		return active.load() && sourceDirty.load();
+	}
+	void copySource(ShapeTableSlot* dest);
+	WavetableMips* getWriteSlot() {
+		return mips.getWriteSlot();
+	}
+	void publish() {
+		mips.publish();
+	}
+
+	// audio thread
+	bool process(double phase, float normFreq, float* out) {
+		// phase is within [0 : 1], normFreq is the oscillator frequency divided by the sample rate
+		// returns false (and out is not written) when nothing has been rendered yet
+		bool isNew;
+		const WavetableMips* m = mips.getReadSlot(&isNew);
+		if (!m->valid) {
+			return false;
+		}
+
+		// mip level: level l is alias-free while (2 * TABLE_SIZE * normFreq) <= 2^(l+1), and the two levels
+		//   that are crossfaded are both alias-free, such that the crossfade is continuous in frequency
+		float level = normFreq * (float)(2 * WavetableMips::TABLE_SIZE);
+		level = level > 1.0f ? std::fmin(fastLog2(level), (float)(WavetableMips::NUM_LEVELS - 1)) : 0.0f;
+		int l0 = (int)level;
+		int l1 = std::min(l0 + 1, WavetableMips::NUM_LEVELS - 1);
+		float lFrac = level - (float)l0;
+
+		// linear interpolation within each level
+		double pos = phase * (double)WavetableMips::TABLE_SIZE;
+		int i = std::min((int)pos, WavetableMips::TABLE_SIZE - 1);
+		float frac = (float)(pos - (double)i);
+		float y0 = m->samples[l0][i] + (m->samples[l0][i + 1] - m->samples[l0][i]) * frac;
+		float y1 = m->samples[l1][i] + (m->samples[l1][i + 1] - m->samples[l1][i]) * frac;
+		*out = y0 + (y1 - y0) * lFrac;
+		return true;
+	}
+};
+
+
+// Background renderer of the wavetables of the 8 channels
+class WavetableRenderer {
+	static const int RENDER_SIZE = WavetableMips::TABLE_SIZE * 4;// shape is sampled 4x oversampled, to limit the aliasing of its corners and jumps before band-limiting
+
+	ShapeWavetable wavetables[8];
+	ShapeTableSlot source;
+	dsp::RealFFT renderFft;
+	dsp::RealFFT tableFft;
+	alignas(16) float renderBuf[RENDER_SIZE];
+	alignas(16) float spectrum[RENDER_SIZE];
+	alignas(16) float levelSpectrum[WavetableMips::TABLE_SIZE];
+	alignas(16) float levelBuf[WavetableMips::TABLE_SIZE];
+
+	// worker, only started once a channel is put in oscillator mode
+	WorkSignal signal;
+	std::thread worker;
+	std::mutex startMtx;
+	Context* context = nullptr;
+
+	void render(ShapeWavetable* wavetable);
+
+
+	public:
+
+	WavetableRenderer();
+
+	~WavetableRenderer() {
+		if (!worker.joinable()) {
+			return;
+		}
+		signal.stop();
+		worker.join();
+	}
+
+	void start();
+
+	ShapeWavetable* getWavetable(int c) {
+		return &wavetables[c];
+	}
+
+	void notify() {
+		signal.notify();
+	}
+
+	void render_worker();
+};
@@ -53,7 +53,7 @@ struct ScopeSettingsButtons : OpaqueWidget {
 	int8_t *settingSrc = nullptr;
 	int* currChan = nullptr;
 	Channel* channels = nullptr;
-	ScopeBuffers* scopeBuffers = nullptr;
+	ScopeEngine* scopeEngine = nullptr;
 	
 	// local
 	std::shared_ptr<Font> font;
@@ -125,7 +125,7 @@ struct ScopeSettingsButtons : OpaqueWidget {
 			if (e.pos.x > leftX && e.pos.x < leftX + textWidthsPx[1]) {
 				// toggle on/off bit, keep vca/sc bit unchanged
 				*settingSrc ^= SCOPE_MASK_ON;
-				scopeBuffers->clear();
+				scopeEngine->clear();
 			}
 			leftX += textWidthsPx[1];
 			// click VCA
@@ -243,8 +243,7 @@ struct ShapeCommandsButtons : OpaqueWidget {// must use Opaque since LightWidget
 				// Push ShapeCompleteChange history action (rest is done further below)
 				ShapeCompleteChange* h = new ShapeCompleteChange;
 				h->shapeSrc = channels[*currChan].getShape();
-				h->oldShape = new Shape();
-				h->shapeSrc->copyShapeTo(h->oldShape);
+				h->captureOld();
 
 				// Internal memory version:
 				// channels[*currChan].pasteShapeFrom(&shapeCpBuffer);
@@ -278,13 +277,12 @@ struct ShapeCommandsButtons : OpaqueWidget {// must use Opaque since LightWidget
 				buttonPressed = 1;
 				
 				if (successPaste) {
-					h->newShape = new Shape();
-					h->shapeSrc->copyShapeTo(h->newShape);
+					h->captureNew();
 					h->name = "paste shape";
 					APP->history->push(h);
 				}
 				else {
-					delete h;// h->oldShape will be automatically deleted by desctructor
+					delete h;// h->oldNodes will be automatically released by desctructor
 				}
 			}
 			leftX += textWidthsPx[1];
@@ -0,0 +1,69 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+
+// Wake-up of a worker thread that sleeps until it is signaled (no timeout polling), from any thread including audio
+//
+// The pending flag is set before the notify, and the mutex is taken in between so that a worker that has just
+//   found no pending work can't miss the notify before it waits (a lost wake-up would leave the work undone until
+//   the next notify, since there is no timeout).
+// Taking the mutex in notify() is acceptable on the audio thread because:
+//   * the workers only hold it to exchange the flag and enter the wait (which releases it), never while working,
+//     so the audio thread can at most wait for those few instructions, and uncontended it is a single atomic op;
+//   * notify() is only called when work is added (a file step, a reverse/invert/random, a wavetable activation),
+//     not at audio rate.
+// Notifying without the mutex would make the audio path lock-free, but then the workers would need a timeout
+//   to recover lost wake-ups, which is the polling this replaces.
+class WorkSignal {
+	std::atomic<bool> pending;
+	std::atomic<bool> requestStop;// set with mtx held
+	std::mutex mtx;
+	std::condition_variable cv;
+
+
+	public:
+
+	WorkSignal() {
+		pending.store(false);
+		requestStop.store(false);
+	}
+
+	void notify() {
+		pending.store(true);
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+		}
+		cv.notify_one();
+	}
+
+	void stop() {
+		std::unique_lock<std::mutex> lk(mtx);
+		requestStop.store(true);
+		lk.unlock();
+		cv.notify_all();
+	}
+
+	bool isStopping() {
+		return requestStop.load();
+	}
+
+	bool wait() {
+		// worker thread, blocks until notified (what was notified before the call counts), returns false when stopping
+		std::unique_lock<std::mutex> lk(mtx);
+		while (!pending.exchange(false) && !requestStop.load()) {
+			cv.wait(lk);
+		}
+		return !requestStop.load();
+	}
+};
@@ -0,0 +1,102 @@
+//***********************************************************************************************
+//Mind Meld Modular: Modules for VCV Rack by Steve Baker and Marc Boulé
+//
+//Based on code from the Fundamental plugin by Andrew Belt
+//See ./LICENSE.md for all licenses
+//***********************************************************************************************
+
+
+// Accuracy test of CurveKernel.hpp against std::pow in double, for the bounds given in its header comment
+// Built and run with "make test-curvekernel" (standalone, not part of the plugin)
+
+
+#include "../CurveKernel.hpp"
+#include <cstdio>
+
+
+static const float MIN_CTRL = 7.5e-8f;// same as Shape::MIN_CTRL
+static const int NUM_C = 20000;
+static const int NUM_X = 1000;
+static const double CURVE_POW_BOUND = 1e-6;// absolute error on y
+static const double EXP2_BOUND = 3e-7;// relative error
+
+
+static float sweepC(int i) {
+	// c within [MIN_CTRL : 1-MIN_CTRL], half of the points are geometric towards each end (where b is small or
+	//   close to 1), the other half are uniform
+	double t = (double)i / (double)(NUM_C - 1);
+	if ((i & 0x1) == 0) {
+		return (float)(MIN_CTRL + t * (1.0 - 2.0 * MIN_CTRL));
+	}
+	double g = std::pow(0.5 / MIN_CTRL, t < 0.5 ? 2.0 * t : 2.0 * (1.0 - t)) * MIN_CTRL;// within [MIN_CTRL : 0.5]
+	return (float)(t < 0.5 ? g : 1.0 - g);
+}
+
+
+struct MaxError {
+	double err = 0.0;
+	float b = 0.0f;
+	float x = 0.0f;
+	
+	void add(double e, float _b, float _x) {
+		if (e > err) {
+			err = e;
+			b = _b;
+			x = _x;
+		}
+	}
+};
+
+
+static void testCurve(float b, MaxError* scalarErr, MaxError* simdErr) {
+	// y(x) := x*b^(2(1-x)), scalar and float_4 against the reference
+	for (int j = 0; j <= NUM_X; j += 4) {
+		simd::float_4 x4;
+		for (int k = 0; k < 4; k++) {
+			x4[k] = (float)std::min(j + k, NUM_X) / (float)NUM_X;
+		}
+		simd::float_4 y4 = x4 * curvePow(simd::float_4(b), 2.0f * (1.0f - x4));
+		for (int k = 0; k < 4; k++) {
+			float x = x4[k];
+			double ref = (double)x * std::pow((double)b, 2.0 * (1.0 - (double)x));
+			float y = x * curvePow(b, 2.0f * (1.0f - x));
+			scalarErr->add(std::fabs((double)y - ref), b, x);
+			simdErr->add(std::fabs((double)y4[k] - ref), b, x);
+		}
+	}
+}
+
+
+static bool check(const char* name, const MaxError& maxErr, double bound) {
+	bool pass = maxErr.err < bound;
+	std::printf("%-22s max error %.3e at b = %.9g, x = %.6f (bound %.0e) %s\n", name, maxErr.err, maxErr.b, maxErr.x, bound, pass ? "ok" : "FAIL");
+	return pass;
+}
+
+
+int main() {
+	// bases of the curves: b = 2c (Shape::_y() and the compiled segments, c mirrored into [MIN_CTRL : 0.5])
+	//   and b = c+1 (Channel::_y(), c within [-1+MIN_CTRL : 0]), hence b = 2c and b = c over the sweep of c
+	MaxError scalarErr;
+	MaxError simdErr;
+	for (int i = 0; i < NUM_C; i++) {
+		float c = sweepC(i);
+		testCurve(c, &scalarErr, &simdErr);
+		testCurve(2.0f * std::min(c, 1.0f - c), &scalarErr, &simdErr);
+	}
+	
+	// fastExp2 over its range, relative
+	MaxError exp2Err;
+	for (int i = -1260000; i <= 1260000; i++) {
+		float x = (float)i * 1e-4f;
+		double ref = std::exp2((double)x);
+		exp2Err.add(std::fabs((double)fastExp2(x) - ref) / ref, 0.0f, x);
+		exp2Err.add(std::fabs((double)fastExp2(simd::float_4(x))[0] - ref) / ref, 0.0f, x);
+	}
+	
+	bool pass = true;
+	pass &= check("curvePow (float)", scalarErr, CURVE_POW_BOUND);
+	pass &= check("curvePow (float_4)", simdErr, CURVE_POW_BOUND);
+	pass &= check("fastExp2 (relative)", exp2Err, EXP2_BOUND);
+	return pass ? 0 : 1;
+}
@@ -26,6 +26,15 @@ struct BassMaster : Module {
 		BYPASS_PARAM,
 		GAIN_PARAM,
 		MIX_PARAM,
+		BANDS_PARAM,// 2 to 4, set in the module's menu like the slope
+		CROSSOVER2_PARAM,// 3 and 4 bands, the crossover knob is then the lowest one
+		CROSSOVER3_PARAM,// 4 bands
+		MID1_WIDTH_PARAM,// 3 and 4 bands, 0 to 2.0f like HIGH_WIDTH_PARAM
+		MID2_WIDTH_PARAM,// 4 bands
+		MID1_SOLO_PARAM,
+		MID2_SOLO_PARAM,
+		MID1_GAIN_PARAM,// -20 to +20 dB
+		MID2_GAIN_PARAM,// -20 to +20 dB
 		NUM_PARAMS
 	};
 	
@@ -48,6 +57,7 @@ struct BassMaster : Module {
 
 	// Constants
 	static constexpr float DEFAULT_SLOPE = 0.0f;
+	static constexpr float DEFAULT_BANDS = 2.0f;
 	static constexpr float SLEW_RATE = 25.0f;
 	int8_t cloakedMode = 0x0;
 	int8_t detailsShow = 0x3;
@@ -57,14 +67,27 @@ struct BassMaster : Module {
 	// none
 	
 	// Need to save, with reset
-	PackedBytes4 miscSettings;// cc4[0] is display label colours, cc4[1] is polyStereo, cc4[2] is VU color, cc4[3] is isMasterTrack
+	PackedBytes4 miscSettings;// cc4[0] is display label colours, cc4[1] is polyStereo (2 = poly voices), cc4[2] is VU color, cc4[3] is isMasterTrack
 	
 	// No need to save, with reset
 	float crossover;
 	bool is24db;
 	bool lowSolo;
 	bool highSolo;
+	bool mid1Solo;
+	bool mid2Solo;
 	LinkwitzRileyStereoCrossover xover;
+	LinkwitzRileyStereo8xCrossover xoverPoly;// used when processing each poly channel separately (max 8 voices)
+	// 3 and 4 bands: the bands are in lanes [0] = low, mid 1, mid 2 (high in 3 band mode), [3] = high (4 band mode)
+	int numBands;
+	float crossover2;
+	float crossover3;
+	LinkwitzRileyStereoMultiCrossover xoverMulti;
+	LinkwitzRileyStereoMultiCrossover xoverMultiPoly[8];
+	TSlewLimiterSingle<simd::float_4> bandWidthSlewers;
+	TSlewLimiterSingle<simd::float_4> bandGainSlewers;
+	TSlewLimiterSingle<simd::float_4> bandSoloSlewers;// 0 when the band is muted by the solo of another band
+	simd::float_4 linearBandGains;
 	TSlewLimiterSingle<simd::float_4> widthAndGainSlewers;// [0] = low width, high width, low gain, [3] = high gain
 	TSlewLimiterSingle<simd::float_4> solosAndBypassSlewers;// [0] = low solo, high solo, bypass, [3] = master gain
 	SlewLimiterSingle mixSlewer;
@@ -95,6 +118,15 @@ struct BassMaster : Module {
 		configParam(BYPASS_PARAM, 0.0f, 1.0f, 0.0f, "Bypass");
 		configParam(GAIN_PARAM, -1.0f, 1.0f, 0.0f, "Master gain", " dB", 0.0f, 20.0f);// diplay params are: base, mult, offset
 		configParam(MIX_PARAM, 0.0f, 1.0f, 1.0f, "Mix", "%", 0.0f, 100.0f);// diplay params are: base, mult, offset
+		configParam(BANDS_PARAM, 2.0f, 4.0f, DEFAULT_BANDS, "Bands");
+		configParam(CROSSOVER2_PARAM, 200.0f, 5000.0f, 1000.0f, "Crossover 2", " Hz");
+		configParam(CROSSOVER3_PARAM, 1000.0f, 15000.0f, 4000.0f, "Crossover 3", " Hz");
+		configParam(MID1_WIDTH_PARAM, 0.0f, 2.0f, 1.0f, "Mid 1 width", "%", 0.0f, 100.0f);// diplay params are: base, mult, offset
+		configParam(MID2_WIDTH_PARAM, 0.0f, 2.0f, 1.0f, "Mid 2 width", "%", 0.0f, 100.0f);// diplay params are: base, mult, offset
+		configParam(MID1_SOLO_PARAM, 0.0f, 1.0f, 0.0f, "Mid 1 solo");
+		configParam(MID2_SOLO_PARAM, 0.0f, 1.0f, 0.0f, "Mid 2 solo");
+		configParam(MID1_GAIN_PARAM, -1.0f, 1.0f, 0.0f, "Mid 1 gain", " dB", 0.0f, 20.0f);// diplay params are: base, mult, offset
+		configParam(MID2_GAIN_PARAM, -1.0f, 1.0f, 0.0f, "Mid 2 gain", " dB", 0.0f, 20.0f);// diplay params are: base, mult, offset
 				
 		configInput(IN_INPUTS + 0, "Left");
 		configInput(IN_INPUTS + 1, "Right");
@@ -110,12 +142,19 @@ struct BassMaster : Module {
 		widthAndGainSlewers.setRiseFall(simd::float_4(SLEW_RATE)); // slew rate is in input-units per second (ex: V/s)		
 		solosAndBypassSlewers.setRiseFall(simd::float_4(SLEW_RATE)); // slew rate is in input-units per second (ex: V/s)	
 		mixSlewer.setRiseFall(SLEW_RATE);
+		bandWidthSlewers.setRiseFall(simd::float_4(SLEW_RATE));
+		bandGainSlewers.setRiseFall(simd::float_4(SLEW_RATE));
+		bandSoloSlewers.setRiseFall(simd::float_4(SLEW_RATE));
 
 		onReset();
 	}
   
 	void onReset() override final {
 		params[SLOPE_PARAM].setValue(DEFAULT_SLOPE);// need this since no wigdet exists
+		// same for the params of the 3 and 4 band modes
+		for (int p = BANDS_PARAM; p <= MID2_GAIN_PARAM; p++) {
+			params[p].setValue(paramQuantities[p]->getDefaultValue());
+		}
 		miscSettings.cc4[0] = 0;// display label colours
 		miscSettings.cc4[1] = 0;// polyStereo
 		miscSettings.cc4[2] = 0;// default color
@@ -127,8 +166,24 @@ struct BassMaster : Module {
 		is24db = params[SLOPE_PARAM].getValue() >= 0.5f;
 		lowSolo = params[LOW_SOLO_PARAM].getValue() >= 0.5f;
 		highSolo = params[HIGH_SOLO_PARAM].getValue() >= 0.5f;
+		mid1Solo = params[MID1_SOLO_PARAM].getValue() >= 0.5f;
+		mid2Solo = params[MID2_SOLO_PARAM].getValue() >= 0.5f;
 		xover.setFilterCutoffs(crossover / APP->engine->getSampleRate(), is24db);
 		xover.reset();
+		xoverPoly.setFilterCutoffs(crossover / APP->engine->getSampleRate(), is24db);
+		xoverPoly.reset();
+		numBands = (int)(params[BANDS_PARAM].getValue() + 0.5f);
+		crossover2 = params[CROSSOVER2_PARAM].getValue();
+		crossover3 = params[CROSSOVER3_PARAM].getValue();
+		setMultiCutoffs(APP->engine->getSampleRate());
+		xoverMulti.reset();
+		for (int c = 0; c < 8; c++) {
+			xoverMultiPoly[c].reset();
+		}
+		bandWidthSlewers.reset();
+		bandGainSlewers.reset();
+		bandSoloSlewers.reset();
+		linearBandGains = 1.0f;
 		widthAndGainSlewers.reset();
 		solosAndBypassSlewers.reset();
 		mixSlewer.reset();
@@ -165,6 +220,108 @@ struct BassMaster : Module {
 
 	void onSampleRateChange() override {
 		xover.setFilterCutoffs(crossover / APP->engine->getSampleRate(), is24db);
+		xoverPoly.setFilterCutoffs(crossover / APP->engine->getSampleRate(), is24db);
+		setMultiCutoffs(APP->engine->getSampleRate());
+	}
+	
+	
+	void setMultiCutoffs(float sampleRate) {
+		// the crossovers are kept in increasing order, the crossover knob being the lowest one
+		if (numBands <= 2) {
+			return;// done when the number of bands changes
+		}
+		float nfcs[3];
+		nfcs[0] = crossover / sampleRate;
+		nfcs[1] = std::max(crossover2, crossover) / sampleRate;
+		nfcs[2] = std::max(crossover3, std::max(crossover2, crossover)) / sampleRate;
+		xoverMulti.setFilterCutoffs(nfcs, numBands, is24db);
+		for (int c = 0; c < 8; c++) {
+			xoverMultiPoly[c].setFilterCutoffs(nfcs, numBands, is24db);
+		}
+	}
+	
+
+	void processBands(simd::float_4 outs, float inLeft, float inRight, float* outStereo) {
+		// outs: [0] = left low, left high, right low, [3] = right high
+		// outStereo: [0] is left, [1] is right
+		// slewers must already be processed for the current sample
+		float dryLeft = 0.0f;
+		float dryRight = 0.0f;
+		if (!IS_JR) {
+			dryLeft = outs[0] + outs[1];
+			dryRight = outs[2] + outs[3];
+		}
+		
+		// Widths (low and high)
+		applyStereoWidth(widthAndGainSlewers.out[0], &outs[0], &outs[2]);// bass width (apply to left low and right low)	
+		applyStereoWidth(widthAndGainSlewers.out[1], &outs[1], &outs[3]);// high width (apply to left high and right high)
+
+		// Gains (low and high)
+		float gLow = linearLowGain * solosAndBypassSlewers.out[1];
+		float gHigh = linearHighGain * solosAndBypassSlewers.out[0];
+		outs *= simd::float_4(gLow, gHigh, gLow, gHigh);
+		
+		// master gain (doesn't apply to Jr)
+		if (!IS_JR) {
+			outs *= linearMasterGain;
+		}
+		
+		// convert to stereo
+		outStereo[0] = outs[0] + outs[1];
+		outStereo[1] = outs[2] + outs[3];
+		
+		processMixAndBypass(dryLeft, dryRight, inLeft, inRight, outStereo);
+	}
+	
+	
+	void processMultiBands(const simd::float_4* outs, float inLeft, float inRight, float* outStereo) {
+		// outs: as given by LinkwitzRileyStereoMultiCrossover::process()
+		// outStereo: [0] is left, [1] is right
+		// slewers must already be processed for the current sample
+		simd::float_4 left = simd::float_4(outs[0][0], outs[0][1], outs[1][0], outs[1][1]);
+		simd::float_4 right = simd::float_4(outs[0][2], outs[0][3], outs[1][2], outs[1][3]);
+		float dryLeft = 0.0f;
+		float dryRight = 0.0f;
+		if (!IS_JR) {
+			dryLeft = left[0] + left[1] + left[2] + left[3];
+			dryRight = right[0] + right[1] + right[2] + right[3];
+		}
+		
+		// Widths (all bands at once, see applyStereoWidth())
+		simd::float_4 wdiv2 = bandWidthSlewers.out * 0.5f;
+		simd::float_4 up = 0.5f + wdiv2;
+		simd::float_4 down = 0.5f - wdiv2;
+		simd::float_4 leftSig = left * up + right * down;
+		simd::float_4 rightSig = right * up + left * down;
+		
+		// Gains and solos
+		simd::float_4 gains = linearBandGains * bandSoloSlewers.out;
+		
+		// master gain (doesn't apply to Jr)
+		if (!IS_JR) {
+			gains *= linearMasterGain;
+		}
+		leftSig *= gains;
+		rightSig *= gains;
+		
+		// convert to stereo
+		outStereo[0] = leftSig[0] + leftSig[1] + leftSig[2] + leftSig[3];
+		outStereo[1] = rightSig[0] + rightSig[1] + rightSig[2] + rightSig[3];
+		
+		processMixAndBypass(dryLeft, dryRight, inLeft, inRight, outStereo);
+	}
+	
+	
+	void processMixAndBypass(float dryLeft, float dryRight, float inLeft, float inRight, float* outStereo) {
+		// mix knob (doesn't apply to Jr)
+		if (!IS_JR) {
+			outStereo[0] = crossfade(dryLeft, outStereo[0], mixSlewer.out);// 0.0 is first arg, 1.0 is second
+			outStereo[1] = crossfade(dryRight, outStereo[1], mixSlewer.out);// 0.0 is first arg, 1.0 is second
+		}
+		
+		// bypass
+		outStereo[0] = crossfade(inLeft, outStereo[0], solosAndBypassSlewers.out[2]);
+		outStereo[1] = crossfade(inRight, outStereo[1], solosAndBypassSlewers.out[2]);
 	}
 	
 
@@ -176,54 +333,46 @@ struct BassMaster : Module {
 			crossover = newCrossover;
 			is24db = newIs24db;
 			xover.setFilterCutoffs(crossover / args.sampleRate, is24db);
-		}
-	
-		// solo mutex mechanism and solo refreshes
-		bool newLowSolo = params[LOW_SOLO_PARAM].getValue() >= 0.5f;
-		if (lowSolo != newLowSolo) {
-			if (newLowSolo) {
-				params[HIGH_SOLO_PARAM].setValue(0.0f);
-				highSolo = 0.0f;
-			}
-			lowSolo = newLowSolo;
-		}	
-		bool newHighSolo = params[HIGH_SOLO_PARAM].getValue() >= 0.5f;
-		if (highSolo != newHighSolo) {
-			if (newHighSolo) {
-				params[LOW_SOLO_PARAM].setValue(0.0f);
-				lowSolo = 0.0f;
-			}
-			highSolo = newHighSolo;	
+			xoverPoly.setFilterCutoffs(crossover / args.sampleRate, is24db);
+			setMultiCutoffs(args.sampleRate);
 		}
 		
-		float inLeft;
-		float inRight;
-		bool polyStereo = miscSettings.cc4[1] != 0 && !inputs[IN_INPUTS + 1].isConnected() && inputs[IN_INPUTS + 0].isPolyphonic();
-		if (polyStereo) {
-			// here were are in polyStero mode, so take all odd numbered into L, even numbered into R (1-indexed)
-			inLeft = 0.0f;
-			inRight = 0.0f;
-			for (int c = 0; c < inputs[IN_INPUTS + 0].getChannels(); c++) {
-				if ((c & 0x1) == 0) {// if L channels (odd channels when 1-indexed)
-					inLeft += inputs[IN_INPUTS + 0].getVoltage(c);
-				}
-				else {
-					inRight += inputs[IN_INPUTS + 0].getVoltage(c);
+		// number of bands and the other crossovers of the 3 and 4 band modes
+		int newNumBands = (int)(params[BANDS_PARAM].getValue() + 0.5f);
+		float newCrossover2 = params[CROSSOVER2_PARAM].getValue();
+		float newCrossover3 = params[CROSSOVER3_PARAM].getValue();
+		if (numBands != newNumBands || crossover2 != newCrossover2 || crossover3 != newCrossover3) {
+			if (numBands != newNumBands) {
+				// the crossover that was not used has old state
+				xover.reset();
+				xoverPoly.reset();
+				xoverMulti.reset();
+				for (int c = 0; c < 8; c++) {
+					xoverMultiPoly[c].reset();
 				}
 			}
+			numBands = newNumBands;
+			crossover2 = newCrossover2;
+			crossover3 = newCrossover3;
+			setMultiCutoffs(args.sampleRate);
 		}
-		else {
-			inLeft = inputs[IN_INPUTS + 0].getVoltageSum();
-			inRight = inputs[IN_INPUTS + 1].getVoltageSum();
-		}
-		
-		simd::float_4 outs = xover.process(clampNothing(inLeft), clampNothing(inRight));
-		// outs: [0] = left low, left high, right low, [3] = right high
-		float dryLeft;
-		float dryRight;
-		if (!IS_JR) {
-			dryLeft = outs[0] + outs[1];
-			dryRight = outs[2] + outs[3];
+	
+		// solo mutex mechanism and solo refreshes (among all four solos, the mid ones are only used in 3 and 4 band modes)
+		const int soloParamIds[4] = {LOW_SOLO_PARAM, MID1_SOLO_PARAM, MID2_SOLO_PARAM, HIGH_SOLO_PARAM};
+		bool* solos[4] = {&lowSolo, &mid1Solo, &mid2Solo, &highSolo};
+		for (int b = 0; b < 4; b++) {
+			bool newSolo = params[soloParamIds[b]].getValue() >= 0.5f;
+			if (*solos[b] != newSolo) {
+				if (newSolo) {
+					for (int o = 0; o < 4; o++) {
+						if (o != b) {
+							params[soloParamIds[o]].setValue(0.0f);
+							*solos[o] = false;
+						}
+					}
+				}
+				*solos[b] = newSolo;
+			}
 		}
 		
 		// Width and gain slewers
@@ -254,10 +403,6 @@ struct BassMaster : Module {
 			linearHighGain = std::pow(10.0f, widthAndGainSlewers.out[3]);
 		}
 		
-		// Widths (low and high)
-		applyStereoWidth(widthAndGainSlewers.out[0], &outs[0], &outs[2]);// bass width (apply to left low and right low)	
-		applyStereoWidth(widthAndGainSlewers.out[1], &outs[1], &outs[3]);// high width (apply to left high and right high)
-
 		// Solos and bypass slewers
 		simd::float_4 solosAndBypass = simd::float_4(lowSolo ? 0.0f : 1.0f, highSolo ? 0.0f : 1.0f, 
 													 params[BYPASS_PARAM].getValue() >= 0.5f ? 0.0f : 1.0f, 
@@ -266,38 +411,110 @@ struct BassMaster : Module {
 			solosAndBypassSlewers.process(args.sampleTime, solosAndBypass);
 			linearMasterGain = std::pow(10.0f, solosAndBypassSlewers.out[3]);
 		}
-
-		// Gains (low and high)
-		float gLow = linearLowGain * solosAndBypassSlewers.out[1];
-		float gHigh = linearHighGain * solosAndBypassSlewers.out[0];
-		outs *= simd::float_4(gLow, gHigh, gLow, gHigh);
 		
-		// master gain (doesn't apply to Jr)
-		if (!IS_JR) {
-			outs *= linearMasterGain;
+		// Band slewers (3 and 4 band modes), in the lanes of the multi-band crossover
+		if (numBands > 2) {
+			bool fourBands = numBands >= 4;
+			simd::float_4 bandWidths = simd::float_4(lowWidth, params[MID1_WIDTH_PARAM].getValue(), 
+													 fourBands ? params[MID2_WIDTH_PARAM].getValue() : highWidth, fourBands ? highWidth : 1.0f);
+			if (movemask(bandWidths == bandWidthSlewers.out) != 0xF) {
+				bandWidthSlewers.process(args.sampleTime, bandWidths);
+			}
+			simd::float_4 bandGains = simd::float_4(params[LOW_GAIN_PARAM].getValue(), params[MID1_GAIN_PARAM].getValue(), 
+													fourBands ? params[MID2_GAIN_PARAM].getValue() : params[HIGH_GAIN_PARAM].getValue(), 
+													fourBands ? params[HIGH_GAIN_PARAM].getValue() : 0.0f);
+			if (movemask(bandGains == bandGainSlewers.out) != 0xF) {
+				bandGainSlewers.process(args.sampleTime, bandGains);
+				for (int b = 0; b < 4; b++) {
+					linearBandGains[b] = std::pow(10.0f, bandGainSlewers.out[b]);
+				}
+			}
+			bool bandSolos[4] = {lowSolo, mid1Solo, fourBands ? mid2Solo : highSolo, fourBands ? highSolo : false};
+			bool anySolo = bandSolos[0] || bandSolos[1] || bandSolos[2] || bandSolos[3];
+			simd::float_4 bandUnmutes;
+			for (int b = 0; b < 4; b++) {
+				bandUnmutes[b] = (anySolo && !bandSolos[b]) ? 0.0f : 1.0f;
+			}
+			if (movemask(bandUnmutes == bandSoloSlewers.out) != 0xF) {
+				bandSoloSlewers.process(args.sampleTime, bandUnmutes);
+			}
 		}
 		
-		// convert to stereo
-		float outStereo[2] = {outs[0] + outs[1], outs[2] + outs[3]};// [0] is left, [1] is right
-		
 		// mix knob (doesn't apply to Jr)
 		if (!IS_JR) {
 			mixSlewer.process(args.sampleTime, params[MIX_PARAM].getValue());
-			outStereo[0] = crossfade(dryLeft, outStereo[0], mixSlewer.out);// 0.0 is first arg, 1.0 is second
-			outStereo[1] = crossfade(dryRight, outStereo[1], mixSlewer.out);// 0.0 is first arg, 1.0 is second
 		}
 		
-		// bypass
-		outStereo[0] = crossfade(inLeft, outStereo[0], solosAndBypassSlewers.out[2]);
-		outStereo[1] = crossfade(inRight, outStereo[1], solosAndBypassSlewers.out[2]);
+		float outStereo[2];// [0] is left, [1] is right
+		bool polyVoices = miscSettings.cc4[1] == 2 && (inputs[IN_INPUTS + 0].isPolyphonic() || inputs[IN_INPUTS + 1].isPolyphonic());
+		if (polyVoices) {
+			// here we are in poly voices mode, so each L/R channel pair gets its own crossover, widths and gains
+			int numVoices = std::min(std::max(inputs[IN_INPUTS + 0].getChannels(), inputs[IN_INPUTS + 1].getChannels()), 8);
+			bool rightConnected = inputs[IN_INPUTS + 1].isConnected();
+			float vuStereo[2] = {0.0f, 0.0f};
+			for (int c = 0; c < numVoices; c++) {
+				float inLeft = inputs[IN_INPUTS + 0].getPolyVoltage(c);
+				float inRight = rightConnected ? inputs[IN_INPUTS + 1].getPolyVoltage(c) : inLeft;
+				if (numBands > 2) {
+					simd::float_4 outs[2];
+					xoverMultiPoly[c].process(clampNothing(inLeft), clampNothing(inRight), outs);
+					processMultiBands(outs, inLeft, inRight, outStereo);
+				}
+				else {
+					simd::float_4 outs = xoverPoly.process(clampNothing(inLeft), clampNothing(inRight), c);
+					processBands(outs, inLeft, inRight, outStereo);
+				}
+				outputs[OUT_OUTPUTS + 0].setVoltage(outStereo[0], c);
+				outputs[OUT_OUTPUTS + 1].setVoltage(outStereo[1], c);
+				vuStereo[0] += outStereo[0];
+				vuStereo[1] += outStereo[1];
+			}
+			outputs[OUT_OUTPUTS + 0].setChannels(numVoices);
+			outputs[OUT_OUTPUTS + 1].setChannels(numVoices);
+			outStereo[0] = vuStereo[0];
+			outStereo[1] = vuStereo[1];
+		}
+		else {
+			float inLeft;
+			float inRight;
+			bool polyStereo = miscSettings.cc4[1] == 1 && !inputs[IN_INPUTS + 1].isConnected() && inputs[IN_INPUTS + 0].isPolyphonic();
+			if (polyStereo) {
+				// here were are in polyStero mode, so take all odd numbered into L, even numbered into R (1-indexed)
+				inLeft = 0.0f;
+				inRight = 0.0f;
+				for (int c = 0; c < inputs[IN_INPUTS + 0].getChannels(); c++) {
+					if ((c & 0x1) == 0) {// if L channels (odd channels when 1-indexed)
+						inLeft += inputs[IN_INPUTS + 0].getVoltage(c);
+					}
+					else {
+						inRight += inputs[IN_INPUTS + 0].getVoltage(c);
+					}
+				}
+			}
+			else {
+				inLeft = inputs[IN_INPUTS + 0].getVoltageSum();
+				inRight = inputs[IN_INPUTS + 1].getVoltageSum();
+			}
+			
+			if (numBands > 2) {
+				simd::float_4 outs[2];
+				xoverMulti.process(clampNothing(inLeft), clampNothing(inRight), outs);
+				processMultiBands(outs, inLeft, inRight, outStereo);
+			}
+			else {
+				simd::float_4 outs = xover.process(clampNothing(inLeft), clampNothing(inRight));
+				processBands(outs, inLeft, inRight, outStereo);
+			}
+			outputs[OUT_OUTPUTS + 0].setChannels(1);
+			outputs[OUT_OUTPUTS + 1].setChannels(1);
+			outputs[OUT_OUTPUTS + 0].setVoltage(outStereo[0]);
+			outputs[OUT_OUTPUTS + 1].setVoltage(outStereo[1]);
+		}
 
 		// VU meter (doesn't apply to Jr)
 		if (!IS_JR) {
 			trackVu.process(args.sampleTime, outStereo);
 		}
-
-		outputs[OUT_OUTPUTS + 0].setVoltage(outStereo[0]);
-		outputs[OUT_OUTPUTS + 1].setVoltage(outStereo[1]);
 	}// process()
 };
 
@@ -348,6 +565,51 @@ struct BassMasterWidget : ModuleWidget {
 		}
 	};	
 	
+	struct BandsItem : MenuItem {
+		Param* srcParam;
+
+		Menu *createChildMenu() override {
+			Menu *menu = new Menu;
+			for (int n = 2; n <= 4; n++) {
+				menu->addChild(createCheckMenuItem(string::f("%i bands", n), "",
+					[=]() {return (int)(srcParam->getValue() + 0.5f) == n;},
+					[=]() {srcParam->setValue((float)n);}
+				));
+			}
+			return menu;
+		}
+	};
+	
+	struct BandParamSlider : ui::Slider {
+		BandParamSlider(ParamQuantity* paramQuantity) {
+			quantity = paramQuantity;// belongs to the module, not deleted here
+			box.size.x = 200.0f;
+		}
+	};
+	
+	struct MidBandItem : MenuItem {
+		// the low and high bands are on the panel, the mid bands of the 3 and 4 band modes are in here
+		BassMaster<IS_JR>* module;
+		int mid;// 0 or 1
+
+		Menu *createChildMenu() override {
+			Menu *menu = new Menu;
+			int crossoverId = mid == 0 ? BassMaster<IS_JR>::CROSSOVER2_PARAM : BassMaster<IS_JR>::CROSSOVER3_PARAM;
+			int widthId = mid == 0 ? BassMaster<IS_JR>::MID1_WIDTH_PARAM : BassMaster<IS_JR>::MID2_WIDTH_PARAM;
+			int gainId = mid == 0 ? BassMaster<IS_JR>::MID1_GAIN_PARAM : BassMaster<IS_JR>::MID2_GAIN_PARAM;
+			int soloId = mid == 0 ? BassMaster<IS_JR>::MID1_SOLO_PARAM : BassMaster<IS_JR>::MID2_SOLO_PARAM;
+			menu->addChild(new BandParamSlider(module->paramQuantities[crossoverId]));
+			menu->addChild(new BandParamSlider(module->paramQuantities[widthId]));
+			menu->addChild(new BandParamSlider(module->paramQuantities[gainId]));
+			Param* soloParam = &(module->params[soloId]);
+			menu->addChild(createCheckMenuItem("Solo", "",
+				[=]() {return soloParam->getValue() >= 0.5f;},
+				[=]() {soloParam->setValue(soloParam->getValue() >= 0.5f ? 0.0f : 1.0f);}
+			));
+			return menu;
+		}
+	};
+	
 	struct VuTypeItem : MenuItem {
 		int8_t* isMasterTypeSrc;
 
@@ -390,8 +652,21 @@ struct BassMasterWidget : ModuleWidget {
 		slopeItem->srcParam = &(module->params[BassMaster<IS_JR>::SLOPE_PARAM]);
 		menu->addChild(slopeItem);		
 
+		BandsItem *bandsItem = createMenuItem<BandsItem>("Bands", RIGHT_ARROW);
+		bandsItem->srcParam = &(module->params[BassMaster<IS_JR>::BANDS_PARAM]);
+		menu->addChild(bandsItem);
+		
+		int numBands = (int)(module->params[BassMaster<IS_JR>::BANDS_PARAM].getValue() + 0.5f);
+		for (int m = 0; m < numBands - 2; m++) {
+			MidBandItem *midBandItem = createMenuItem<MidBandItem>(numBands == 3 ? "Mid band" : string::f("Mid %i band", m + 1), RIGHT_ARROW);
+			midBandItem->module = module;
+			midBandItem->mid = m;
+			menu->addChild(midBandItem);
+		}
+
 		PolyStereoItem *polySteItem = createMenuItem<PolyStereoItem>("Poly input behavior", RIGHT_ARROW);
 		polySteItem->polyStereoSrc = &(module->miscSettings.cc4[1]);
+		polySteItem->allowPolyVoices = true;
 		menu->addChild(polySteItem);
 
 		menu->addChild(new MenuSeparator());
@@ -1,6 +1,7 @@
 //***********************************************************************************************
 //Split/merge to/from Left/Right that spaces out the signals for compatibility with EQ master
 //Used for mid/side eq'ing with two EqMasters, using MixMaster inserts and VCV Mid/Side modules 
+//  (or with the built-in mid/side encode/decode mode, which removes the need for Mid/Side modules)
 //For VCV Rack by Steve Baker and Marc Boulé 
 //
 //Based on code from the Fundamental plugin by Andrew Belt 
@@ -11,6 +12,27 @@
 #include "../MindMeldModular.hpp"
 
 
+// Each float_4 holds 2 stereo pairs of an aggregate cable: L0, R0, L1, R1
+// Split outputs hold the signal of a pair in even channels and 0.0f in odd channels: X0, 0, X1, 0
+
+static inline simd::float_4 evenLanes(simd::float_4 v) {// v0, 0, v2, 0
+	return v & simd::float_4::cast(simd::int32_4(-1, 0, -1, 0));
+}
+
+static inline simd::float_4 swapPairLanes(simd::float_4 v) {// v1, v0, v3, v2
+	return simd::float_4(_mm_shuffle_ps(v.v, v.v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+static inline simd::float_4 dupEvenLanes(simd::float_4 v) {// v0, v0, v2, v2
+	return simd::float_4(_mm_shuffle_ps(v.v, v.v, _MM_SHUFFLE(2, 2, 0, 0)));
+}
+
+static inline simd::float_4 interleaveEvenLanes(simd::float_4 a, simd::float_4 b) {// a0, b0, a2, b2
+	simd::float_4 ab = simd::float_4(_mm_shuffle_ps(a.v, b.v, _MM_SHUFFLE(2, 0, 2, 0)));// a0, a2, b0, b2
+	return simd::float_4(_mm_shuffle_ps(ab.v, ab.v, _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+
 struct MSMelder : Module {
 	
 	enum ParamIds {
@@ -56,7 +78,7 @@ struct MSMelder : Module {
 	// none
 	
 	// Need to save, with reset
-	// none
+	bool midSide;// when true, split outputs are mid (left jacks) and side (right jacks), and merge inputs are decoded back to L/R
 	
 	// No need to save, with reset
 	// none
@@ -82,6 +104,7 @@ struct MSMelder : Module {
 	}
   
 	void onReset() override final {
+		midSide = false;
 		resetNonJson(false);
 	}
 	void resetNonJson(bool recurseNonJson) {
@@ -95,11 +118,19 @@ struct MSMelder : Module {
 	json_t *dataToJson() override {
 		json_t *rootJ = json_object();
 
+		// midSide
+		json_object_set_new(rootJ, "midSide", json_boolean(midSide));
+
 		return rootJ;
 	}
 
 
 	void dataFromJson(json_t *rootJ) override {
+		// midSide
+		json_t *midSideJ = json_object_get(rootJ, "midSide");
+		if (midSideJ)
+			midSide = json_is_true(midSideJ);
+
 		resetNonJson(true);	
 	}
 
@@ -129,20 +160,31 @@ struct MSMelder : Module {
 		}// userInputs refresh
 		
 		
-		// Outputs
+		// Outputs (2 stereo pairs at a time)
 		for (int i = 0; i < 3; i++) {
-			int chansDiv2 = inputs[A_INPUT + i].getChannels() >> 1;
-			for (int c = 0; c < chansDiv2; c++) {
-				// split
-				outputs[AL_OUTPUT + i].setVoltage(inputs[A_INPUT + i].getVoltage(c * 2 + 0), c * 2 + 0);
-				outputs[AL_OUTPUT + i].setVoltage(0.0f, c * 2 + 1);
-				
-				outputs[AR_OUTPUT + i].setVoltage(inputs[A_INPUT + i].getVoltage(c * 2 + 1), c * 2 + 0);
-				outputs[AR_OUTPUT + i].setVoltage(0.0f, c * 2 + 1);
-				
-				// merge
-				outputs[A_OUTPUT + i].setVoltage(inputs[AL_INPUT + i].getVoltage(c * 2 + 0), c * 2 + 0);
-				outputs[A_OUTPUT + i].setVoltage(inputs[AR_INPUT + i].getVoltage(c * 2 + 0), c * 2 + 1);
+			int chans = inputs[A_INPUT + i].getChannels() & ~0x1;
+			for (int c = 0; c < chans; c += 4) {
+				simd::float_4 agg = inputs[A_INPUT + i].getVoltageSimd<simd::float_4>(c);
+				simd::float_4 inL = inputs[AL_INPUT + i].getVoltageSimd<simd::float_4>(c);
+				simd::float_4 inR = inputs[AR_INPUT + i].getVoltageSimd<simd::float_4>(c);
+				if (midSide) {
+					// split with encode: M = (L + R) / 2, S = (L - R) / 2
+					simd::float_4 aggSwapped = swapPairLanes(agg);
+					outputs[AL_OUTPUT + i].setVoltageSimd(evenLanes((agg + aggSwapped) * 0.5f), c);
+					outputs[AR_OUTPUT + i].setVoltageSimd(evenLanes((agg - aggSwapped) * 0.5f), c);
+					
+					// merge with decode: L = M + S, R = M - S
+					simd::float_4 sideSigned = dupEvenLanes(inR) * simd::float_4(1.0f, -1.0f, 1.0f, -1.0f);
+					outputs[A_OUTPUT + i].setVoltageSimd(dupEvenLanes(inL) + sideSigned, c);
+				}
+				else {
+					// split
+					outputs[AL_OUTPUT + i].setVoltageSimd(evenLanes(agg), c);
+					outputs[AR_OUTPUT + i].setVoltageSimd(evenLanes(swapPairLanes(agg)), c);
+					
+					// merge
+					outputs[A_OUTPUT + i].setVoltageSimd(interleaveEvenLanes(inL, inR), c);
+				}
 			}
 		}
 		
@@ -159,6 +201,19 @@ struct MSMelder : Module {
 
 
 struct MSMelderWidget : ModuleWidget {
+	void appendContextMenu(Menu *menu) override {
+		MSMelder *module = static_cast<MSMelder*>(this->module);
+		assert(module);
+
+		menu->addChild(new MenuSeparator());
+		
+		menu->addChild(createCheckMenuItem("Mid/side encode and decode", "",
+			[=]() {return module->midSide;},
+			[=]() {module->midSide = !module->midSide;}
+		));
+	}	
+	
+	
 	MSMelderWidget(MSMelder *module) {
 		setModule(module);
 
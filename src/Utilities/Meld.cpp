@@ -46,6 +46,8 @@ struct Meld : Module {
 	
 	// No need to save, with reset
 	int lastMergeInputIndex;// can be -1 when nothing connected
+	uint16_t mergeConnected;// bit c is set when MERGE_INPUTS + c is connected, refreshed with the inputs
+	simd::float_4 bypassVect[4];// target of bypassSlewersVect, 1.0f when a merge input is unconnected or its track is bypassed
 	TSlewLimiterSingle<simd::float_4> bypassSlewersVect[4];
 	
 	// No need to save, no reset
@@ -53,19 +55,26 @@ struct Meld : Module {
 	Trigger bypassTriggers[8];
 	
 	
-	void calcLastMergeInputIndex() {// can set to -1 when nothing connected
-		int i = 15;
-		for (; i >= 0; i--) {
-			if (inputs[MERGE_INPUTS + i].isConnected()) {
-				break;
+	void calcConnectedAndBypass() {// lastMergeInputIndex can be set to -1 when nothing connected
+		mergeConnected = 0;
+		lastMergeInputIndex = -1;
+		for (int c = 0; c < 16; c++) {
+			if (inputs[MERGE_INPUTS + c].isConnected()) {
+				mergeConnected |= (1 << c);
+				lastMergeInputIndex = c;
 			}
 		}
-		lastMergeInputIndex = i;
-		return;
+		calcBypassVect();
+	}
+	
+	void calcBypassVect() {
+		for (int c = 0; c < 16; c++) {
+			bypassVect[c >> 2][c & 0x3] = ((mergeConnected & (1 << c)) == 0 || (bypassState[c >> 1] == 1)) ? 1.0f : 0.0f;
+		}
 	}
 	
 	bool trackInUse(int trk) {// trk is 0 to 7
-		return inputs[MERGE_INPUTS + trk * 2 + 0].isConnected() || inputs[MERGE_INPUTS + trk * 2 + 1].isConnected();
+		return (mergeConnected & (0x3 << (trk * 2))) != 0;
 	}
 	
 	
@@ -102,7 +111,7 @@ struct Meld : Module {
 		resetNonJson(false);
 	}
 	void resetNonJson(bool recurseNonJson) {
-		calcLastMergeInputIndex();
+		calcConnectedAndBypass();
 		for (int i = 0; i < 16; i++) {
 			bypassSlewersVect[i >> 2].out[i & 0x3] = (float)bypassState[i >> 1];
 		}
@@ -158,12 +167,13 @@ struct Meld : Module {
 	void process(const ProcessArgs &args) override {
 		// Controls
 		if (refresh.processInputs()) {
-			calcLastMergeInputIndex();
+			calcConnectedAndBypass();
 			
 			for (int trk = 0; trk < 8; trk++) {
 				if (bypassTriggers[trk].process(params[BYPASS_PARAMS + trk].getValue())) {
 					if (trackInUse(trk)) {
 						bypassState[trk] ^= 0x1;
+						calcBypassVect();
 					}
 				}
 			}
@@ -177,12 +187,13 @@ struct Meld : Module {
 		outputs[OUT_OUTPUT].setChannels(numChan);// clears all and sets num chan to 1 when numChan == 0
 
 		// simd version
-		simd::float_4 bypassVect[4];
-		for (int c = 0; c < 16; c++) {
-			bypassVect[c >> 2][c & 0x3] = (!inputs[MERGE_INPUTS + c].isConnected() || (bypassState[c >> 1] == 1)) ? 1.0f : 0.0f;
-		}
+		// all bypass slewers are stepped, so that groups that become active do not start from stale gains
 		for (int i = 0; i < 4; i++) {
-			bypassSlewersVect[i].process(args.sampleTime, bypassVect[i]);
+			if (movemask(bypassVect[i] == bypassSlewersVect[i].out) != 0xF) {// movemask returns 0xF when 4 floats are equal
+				bypassSlewersVect[i].process(args.sampleTime, bypassVect[i]);
+			}
+		}
+		for (int i = 0; i < (numChan + 3) >> 2; i++) {
 			simd::float_4 vVect{inputs[MERGE_INPUTS + i * 4 + 0].getVoltage(),
 				inputs[MERGE_INPUTS + i * 4 + 1].getVoltage(),
 				inputs[MERGE_INPUTS + i * 4 + 2].getVoltage(),
@@ -197,7 +208,7 @@ struct Meld : Module {
 			for (int i = 0; i < 16; i++) {
 				float greenBright = 0.0f;
 				float blueBright = 0.0f;
-				if (i <= lastMergeInputIndex && inputs[MERGE_INPUTS + i].isConnected() && (bypassState[i >> 1] == 0)) {
+				if ((mergeConnected & (1 << i)) != 0 && (bypassState[i >> 1] == 0)) {
 					greenBright = 1.0f;
 				}
 				else if (i < numChan) {
@@ -43,7 +43,8 @@ struct Unmeld : Module {
 	// none
 	
 	// No need to save, with reset
-	// none
+	int lastNumChan;
+	uint16_t splitConnected;// bit c is set when SPLIT_OUTPUTS + c is connected, refreshed with the inputs
 
 	// No need to save, no reset
 	RefreshCounter refresh;	
@@ -71,6 +72,17 @@ struct Unmeld : Module {
 		resetNonJson(false);
 	}
 	void resetNonJson(bool recurseNonJson) {
+		lastNumChan = -1;
+		calcSplitConnected();
+	}
+	
+	void calcSplitConnected() {
+		splitConnected = 0;
+		for (int c = 0; c < 16; c++) {
+			if (outputs[SPLIT_OUTPUTS + c].isConnected()) {
+				splitConnected |= (1 << c);
+			}
+		}
 	}
 
 
@@ -104,26 +116,29 @@ struct Unmeld : Module {
 	void process(const ProcessArgs &args) override {
 		// Controls
 		if (refresh.processInputs()) {
-			// none
+			calcSplitConnected();
 		}// userInputs refresh
 		
 		
 		// Thru
 		int numChan = inputs[POLY_INPUT].getChannels();
 		outputs[THRU_OUTPUT].setChannels(numChan);
-		for (int c = 0; c < numChan; c++) {
-			float v = inputs[POLY_INPUT].getVoltage(c);
-			outputs[THRU_OUTPUT].setVoltage(v, c);
+		for (int c = 0; c < numChan; c += 4) {
+			outputs[THRU_OUTPUT].setVoltageSimd(inputs[POLY_INPUT].getVoltageSimd<simd::float_4>(c), c);
 		}
 		
-		// Split
-		int c = 0;
-		for (; c < numChan; c++) {
-			float v = inputs[POLY_INPUT].getVoltage(c);
-			outputs[SPLIT_OUTPUTS + c].setVoltage(v);
+		// Split (only connected outputs, unused ones are zeroed when the channel count changes)
+		const float* v = inputs[POLY_INPUT].getVoltages();
+		for (int c = 0; c < numChan; c++) {
+			if ((splitConnected & (1 << c)) != 0) {
+				outputs[SPLIT_OUTPUTS + c].setVoltage(v[c]);
+			}
 		}		
-		for (; c < 16; c++) {
-			outputs[SPLIT_OUTPUTS + c].setVoltage(0.0f);
+		if (numChan != lastNumChan) {
+			for (int c = std::max(numChan, 0); c < 16; c++) {
+				outputs[SPLIT_OUTPUTS + c].setVoltage(0.0f);
+			}
+			lastNumChan = numChan;
 		}
 		
 		// Lights
@@ -154,3 +154,252 @@ class LinkwitzRileyStereo8xCrossover : public LinkwitzRileyCoefficients {
 		return outS2;
 	}
 };
+
+
+// Up to 16 mono channels with 4 channels per float_4, where the low and high outputs are mixed with given gains
+// States are channel-major (4 groups of 4 channels) so that a whole poly cable is filtered with no lane shuffling
+class LinkwitzRileyPolyCrossover : public LinkwitzRileyCoefficients {
+	simd::float_4 xS1[4][2][3 - 1];// [group][0 = low, 1 = high][tap]
+	simd::float_4 yS1[4][2][3 - 1];
+	simd::float_4 xS2[4][2][3 - 1];
+	simd::float_4 yS2[4][2][3 - 1];
+	
+	
+	public: 
+		
+	void reset() {
+		for (int g = 0; g < 4; g++) {
+			for (int band = 0; band < 2; band++) {
+				for (int i = 0; i < 2; i++) {
+					xS1[g][band][i] = 0.0f;
+					yS1[g][band][i] = 0.0f;
+					xS2[g][band][i] = 0.0f;
+					yS2[g][band][i] = 0.0f;
+				}
+			}
+		}
+	}
+
+	void processMix(const float* ins, float* outs, int numChans, float gainLow, float gainHigh) {
+		// outs[c] = low(ins[c]) * gainLow + high(ins[c]) * gainHigh
+		// ins and outs are accessed 4 channels at a time, so they must be sized for numChans rounded up to a multiple of 4
+		if (!secondOrderFilters) {
+			gainLow *= -1.0f;// phase correction needed for first order filters, done on the low output instead of its input since the filter is linear
+		}
+		simd::float_4 bb[2][3];
+		for (int band = 0; band < 2; band++) {
+			for (int i = 0; i < 3; i++) {
+				bb[band][i] = simd::float_4(b[i][band]);// lanes 0 and 1 of b are left low and left high
+			}
+		}
+		
+		for (int g = 0; g < ((numChans + 3) >> 2); g++) {
+			simd::float_4 in = simd::float_4::load(&ins[g << 2]);
+			simd::float_4 mix = 0.0f;
+			for (int band = 0; band < 2; band++) {
+				// stage 1
+				simd::float_4 outS1 = bb[band][0] * in + bb[band][1] * xS1[g][band][0] + bb[band][2] * xS1[g][band][1] - a[0] * yS1[g][band][0] - a[1] * yS1[g][band][1];
+				xS1[g][band][1] = xS1[g][band][0];
+				xS1[g][band][0] = in;
+				yS1[g][band][1] = yS1[g][band][0];
+				yS1[g][band][0] = outS1;
+
+				// stage 2 (outS1 used as in)
+				simd::float_4 outS2 = bb[band][0] * outS1 + bb[band][1] * xS2[g][band][0] + bb[band][2] * xS2[g][band][1] - a[0] * yS2[g][band][0] - a[1] * yS2[g][band][1];
+				xS2[g][band][1] = xS2[g][band][0];
+				xS2[g][band][0] = outS1;
+				yS2[g][band][1] = yS2[g][band][0];
+				yS2[g][band][0] = outS2;
+				
+				mix += outS2 * (band == 0 ? gainLow : gainHigh);
+			}
+			mix.store(&outs[g << 2]);
+		}
+	}
+};
+
+
+// Four independent lanes of two cascaded biquad sections, where each lane can be a low, high, allpass or wire
+// Used to build crossover trees where the allpass compensation must match the L-R type of the splits
+class LinkwitzRileyLanes {
+	simd::float_4 bS1[3];// section 1 coefficients b0, b1 and b2, one lane per float
+	simd::float_4 aS1[3 - 1];// section 1 coefficients a1 and a2, one lane per float
+	simd::float_4 bS2[3];
+	simd::float_4 aS2[3 - 1];
+	simd::float_4 xS1[3 - 1];
+	simd::float_4 yS1[3 - 1];
+	simd::float_4 xS2[3 - 1];
+	simd::float_4 yS2[3 - 1];
+	
+	
+	public: 
+	
+	enum LaneTypes {LANE_LOW, LANE_HIGH, LANE_ALLPASS, LANE_WIRE};
+	
+	LinkwitzRileyLanes() {
+		for (int l = 0; l < 4; l++) {
+			setLane(l, 0.1f, false, LANE_WIRE);
+		}
+		reset();
+	}
+		
+	void reset() {
+		for (int i = 0; i < 2; i++) {
+			xS1[i] = 0.0f;
+			yS1[i] = 0.0f;
+			xS2[i] = 0.0f;
+			yS2[i] = 0.0f;
+		}
+	}
+	
+	void setLane(int lane, float nfc, bool secondOrder, int laneType) {
+		// nfc: normalized cutoff frequency (cutoff frequency / sample rate), must be > 0 (ignored for LANE_WIRE)
+		// see LinkwitzRileyCoefficients::setFilterCutoffs() for the pre-warping and the LPF/HPF coefficients
+		float nfcw = nfc < 0.025f ? float(M_PI) * nfc : std::tan(float(M_PI) * std::min(0.499f, nfc));
+		float b0, b1, b2, a1, a2;
+		
+		if (secondOrder) {	
+			float acst = nfcw * nfcw + nfcw * float(M_SQRT2) + 1.0f;
+			a1 = 2.0f * (nfcw * nfcw - 1.0f) / acst;
+			a2 = (nfcw * nfcw - nfcw * float(M_SQRT2) + 1.0f) / acst;
+			float hbcst = 1.0f / acst;
+			float lbcst = hbcst * nfcw * nfcw;
+			if (laneType == LANE_LOW) {
+				b0 = lbcst; b1 = 2.0f * lbcst; b2 = lbcst;
+			}
+			else if (laneType == LANE_HIGH) {
+				b0 = hbcst; b1 = -2.0f * hbcst; b2 = hbcst;
+			}
+			else {
+				// allpass of a 4th order L-R crossover (LP^2 + HP^2) is a 2nd order allpass with the same poles
+				b0 = a2; b1 = a1; b2 = 1.0f;
+			}
+		}
+		else {
+			a1 = (nfcw - 1.0f) / (nfcw + 1.0f);
+			a2 = 0.0f;
+			float hbcst = 1.0f / (1.0f + nfcw);
+			float lbcst = 1.0f - hbcst;
+			b2 = 0.0f;
+			if (laneType == LANE_LOW) {
+				b0 = -lbcst; b1 = -lbcst;// phase correction needed for first order filters (used to make 2nd order L-R crossover)
+			}
+			else if (laneType == LANE_HIGH) {
+				b0 = hbcst; b1 = -hbcst;
+			}
+			else {
+				// allpass of a 2nd order L-R crossover (HP^2 - LP^2 = HP - LP) is a 1st order allpass
+				b0 = -a1; b1 = -1.0f;
+			}
+		}
+		if (laneType == LANE_WIRE) {
+			b0 = 1.0f; b1 = 0.0f; b2 = 0.0f; a1 = 0.0f; a2 = 0.0f;
+		}
+		
+		bS1[0][lane] = b0;
+		bS1[1][lane] = b1;
+		bS1[2][lane] = b2;
+		aS1[0][lane] = a1;
+		aS1[1][lane] = a2;
+		if (laneType == LANE_LOW || laneType == LANE_HIGH) {
+			float neg = (!secondOrder && laneType == LANE_LOW) ? -1.0f : 1.0f;// phase correction only applied once
+			bS2[0][lane] = b0 * neg;
+			bS2[1][lane] = b1 * neg;
+			bS2[2][lane] = b2;
+			aS2[0][lane] = a1;
+			aS2[1][lane] = a2;
+		}
+		else {
+			// allpass and wire only need one section
+			bS2[0][lane] = 1.0f;
+			bS2[1][lane] = 0.0f;
+			bS2[2][lane] = 0.0f;
+			aS2[0][lane] = 0.0f;
+			aS2[1][lane] = 0.0f;
+		}
+	}
+
+	simd::float_4 process(simd::float_4 in) {
+		// stage 1
+		simd::float_4 outS1 = bS1[0] * in + bS1[1] * xS1[0] + bS1[2] * xS1[1] - aS1[0] * yS1[0] - aS1[1] * yS1[1];
+		xS1[1] = xS1[0];
+		xS1[0] = in;
+		yS1[1] = yS1[0];
+		yS1[0] = outS1;
+
+		// stage 2 (outS1 used as in)
+		simd::float_4 outS2 = bS2[0] * outS1 + bS2[1] * xS2[0] + bS2[2] * xS2[1] - aS2[0] * yS2[0] - aS2[1] * yS2[1];
+		xS2[1] = xS2[0];
+		xS2[0] = outS1;
+		yS2[1] = yS2[0];
+		yS2[0] = outS2;
+
+		return outS2;
+	}
+};
+
+
+// Stereo 3 or 4 band crossover tree: 
+//   the input is first split at the middle cutoff, then each branch is allpass compensated with the cutoff 
+//   used in the other branch, and finally each branch is split again (the upper branch is not split in 3 band mode)
+// The sum of all bands is thus an allpass (flat magnitude), like in the 2 band crossover
+class LinkwitzRileyStereoMultiCrossover {
+	LinkwitzRileyLanes splitMid;// LeftLow, LeftHigh, RightLow, RightHigh
+	LinkwitzRileyLanes allpassComp;// same lanes as splitMid
+	LinkwitzRileyLanes splitLow;// Left band 0, Left band 1, Right band 0, Right band 1
+	LinkwitzRileyLanes splitHigh;// Left band 2, Left band 3, Right band 2, Right band 3
+	int numBands = 4;
+	
+	
+	public: 
+	
+	void reset() {
+		splitMid.reset();
+		allpassComp.reset();
+		splitLow.reset();
+		splitHigh.reset();
+	}
+	
+	int getNumBands() {
+		return numBands;
+	}
+	
+	void setFilterCutoffs(const float* nfcs, int _numBands, bool secondOrder) {
+		// nfcs: (_numBands - 1) normalized cutoff frequencies in increasing order
+		// _numBands: 3 or 4
+		numBands = _numBands;
+		float nfcLow = nfcs[0];
+		float nfcMid = nfcs[1];
+		
+		for (int s = 0; s < 2; s++) {
+			splitMid.setLane(2 * s + 0, nfcMid, secondOrder, LinkwitzRileyLanes::LANE_LOW);
+			splitMid.setLane(2 * s + 1, nfcMid, secondOrder, LinkwitzRileyLanes::LANE_HIGH);
+			splitLow.setLane(2 * s + 0, nfcLow, secondOrder, LinkwitzRileyLanes::LANE_LOW);
+			splitLow.setLane(2 * s + 1, nfcLow, secondOrder, LinkwitzRileyLanes::LANE_HIGH);
+			allpassComp.setLane(2 * s + 1, nfcLow, secondOrder, LinkwitzRileyLanes::LANE_ALLPASS);
+			if (numBands >= 4) {
+				float nfcHigh = nfcs[2];
+				allpassComp.setLane(2 * s + 0, nfcHigh, secondOrder, LinkwitzRileyLanes::LANE_ALLPASS);
+				splitHigh.setLane(2 * s + 0, nfcHigh, secondOrder, LinkwitzRileyLanes::LANE_LOW);
+				splitHigh.setLane(2 * s + 1, nfcHigh, secondOrder, LinkwitzRileyLanes::LANE_HIGH);
+			}
+			else {
+				allpassComp.setLane(2 * s + 0, 0.1f, secondOrder, LinkwitzRileyLanes::LANE_WIRE);
+			}
+		}
+	}
+
+	void process(float left, float right, simd::float_4* outs) {
+		// outs[0] = left band 0, left band 1, right band 0, right band 1
+		// outs[1] = left band 2, left band 3, right band 2, right band 3 (band 3 is 0.0f in 3 band mode)
+		simd::float_4 mid = splitMid.process(simd::float_4(left, left, right, right));
+		mid = allpassComp.process(mid);
+		outs[0] = splitLow.process(simd::float_4(mid[0], mid[0], mid[2], mid[2]));
+		if (numBands >= 4) {
+			outs[1] = splitHigh.process(simd::float_4(mid[1], mid[1], mid[3], mid[3]));
+		}
+		else {
+			outs[1] = simd::float_4(mid[1], 0.0f, mid[3], 0.0f);
+		}
+	}
+};